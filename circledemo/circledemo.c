@@ -0,0 +1,37 @@
+/** \file circledemo.c
+ *  \brief Draws circles, an ellipse and lines with lcdLib's span shapes
+ */
+
+#include <libTimer.h>
+#include "lcdutils.h"
+#include "lcddraw.h"
+#include "lcdshapes.h"
+
+/** Initializes everything, draws a target, an eye and a sunburst,
+ *  then sleeps */
+void
+main()
+{
+  configureClocks();
+  lcd_init();
+
+  clearScreen(COLOR_NAVY);
+
+  /* target: filled rings, outlined */
+  fillCircle(64, 40, 30, COLOR_RED);
+  fillCircle(64, 40, 20, COLOR_WHITE);
+  fillCircle(64, 40, 10, COLOR_RED);
+  drawCircle(64, 40, 30, COLOR_YELLOW);
+
+  /* eye: ellipse with a pupil */
+  fillEllipse(64, 95, 40, 15, COLOR_WHITE);
+  fillCircle(64, 95, 8, COLOR_BLACK);
+
+  /* sunburst: lines of every slope from one point */
+  for (u_char col = 4; col < screenWidth; col += 12) {
+    drawLine(64, 159, col, 120, COLOR_GOLD);
+  }
+  drawLine(0, 118, screenWidth - 1, 118, COLOR_GREEN);
+
+  or_sr(0x10);			/**< CPU OFF (LPM0) for good */
+}
@@ -0,0 +1,253 @@
+#include <msp430.h>
+#include <string.h>
+#include "libTimer.h"
+#include "flashStore.h"
+
+#define SEG_SIZE   64
+#define SEGMENTS   3
+#define HEADER     2		// sequence number
+#define OVERHEAD   4		// tag, len, crc
+#define ERASED     0xff
+
+// flash timing generator: MCLK (16MHz) / 40 = 400kHz, inside 257-476kHz
+#define FLASH_DIV  (16000000L / 400000 - 1)
+
+// segments in log order: D, C, B
+static unsigned char * const seg[SEGMENTS] = {
+  (unsigned char *)0x1000, (unsigned char *)0x1040, (unsigned char *)0x1080
+};
+
+static unsigned int seq[SEGMENTS];
+static char head;			// segment being appended to
+static unsigned char headOff;		// first free byte in it
+static const unsigned char *latest[FLASH_TAGS]; // newest record (0: none)
+
+#define CRC_INIT   0xffff
+
+static unsigned int
+crc16(unsigned int crc, const unsigned char *p, unsigned char len)
+{
+  while (len--) {			// CRC-16/CCITT, MSB first
+    crc ^= (unsigned int)*p++ << 8;
+    for (char i = 0; i < 8; i++)
+      crc = (crc & 0x8000) ? (crc << 1) ^ 0x1021 : crc << 1;
+  }
+  return crc & 0xffff;
+}
+
+static char
+record_ok(const unsigned char *r)
+{
+  unsigned char n = 2 + r[1];
+  return (r[n] | (r[n + 1] << 8)) == crc16(CRC_INIT, r, n);
+}
+
+// --------------------------------------------------
+// Flash controller.  Interrupts stay off while the controller is
+// unlocked; running from flash, the CPU is held until each operation
+// completes.
+// --------------------------------------------------
+static void
+flash_erase(unsigned char *s)
+{
+  int sr = get_sr();
+  and_sr(~0x8);
+  FCTL2 = FWKEY + FSSEL_1 + FLASH_DIV;
+  FCTL3 = FWKEY;			// unlock (LOCKA unchanged)
+  FCTL1 = FWKEY + ERASE;
+  *s = 0;				// dummy write starts the segment erase
+  FCTL1 = FWKEY;
+  FCTL3 = FWKEY + LOCK;
+  set_sr(sr);
+}
+
+static void
+flash_write(unsigned char *dst, const unsigned char *src, unsigned char len)
+{
+  int sr = get_sr();
+  and_sr(~0x8);
+  FCTL2 = FWKEY + FSSEL_1 + FLASH_DIV;
+  FCTL3 = FWKEY;
+  FCTL1 = FWKEY + WRT;
+  while (len--)
+    *dst++ = *src++;
+  FCTL1 = FWKEY;
+  FCTL3 = FWKEY + LOCK;
+  set_sr(sr);
+}
+
+// append one record at the head; the caller checked that it fits
+static void
+append(unsigned char tag, const void *data, unsigned char len)
+{
+  unsigned char hdr[2], crc[2];
+  unsigned char *r = seg[(int)head] + headOff;
+  unsigned int c;
+
+  hdr[0] = tag;
+  hdr[1] = len;
+  c = crc16(crc16(CRC_INIT, hdr, 2), data, len);
+  crc[0] = c;
+  crc[1] = c >> 8;
+  flash_write(r, hdr, 2);
+  flash_write(r + 2, data, len);
+  flash_write(r + 2 + len, crc, 2);
+  headOff += len + OVERHEAD;
+  latest[tag] = len ? r : 0;
+}
+
+// sequence number after n, skipping 0xffff (erased)
+static unsigned int
+seq_next(unsigned int n)
+{
+  return n == 0xfffe ? 0 : n + 1;
+}
+
+// does segment s carry on from the segment before it?
+static char
+follows(char s)
+{
+  char prev = (s + SEGMENTS - 1) % SEGMENTS;
+  return seq[(int)s] != 0xffff && seq[(int)prev] != 0xffff
+    && seq[(int)s] == seq_next(seq[(int)prev]);
+}
+
+// blank (all 0xff)?
+static char
+erased(const unsigned char *s)
+{
+  for (unsigned char i = 0; i < SEG_SIZE; i++)
+    if (s[i] != ERASED)
+      return 0;
+  return 1;
+}
+
+// bytes the current records take
+static unsigned char
+live()
+{
+  unsigned char n = 0;
+  for (char t = 0; t < FLASH_TAGS; t++)
+    if (latest[(int)t])
+      n += latest[(int)t][1] + OVERHEAD;
+  return n;
+}
+
+// Move the head to the spare segment.  The log is the head and the
+// segment before it; the one after the head is the spare.  The records
+// of the older log segment that are still current (with all, those of
+// the head too) are copied into the spare first, and only then is the
+// spare's sequence number written: until that point a reset leaves the
+// log as it was.  The older segment becomes the new spare, erased the
+// next time round.
+static void
+advance(char all)
+{
+  char next = (head + 1) % SEGMENTS, old = (head + 2) % SEGMENTS;
+  unsigned char hdr[HEADER];
+
+  if (!erased(seg[(int)next]))
+    flash_erase(seg[(int)next]);
+  headOff = HEADER;
+  for (char t = 0; t < FLASH_TAGS; t++) {
+    const unsigned char *r = latest[(int)t];
+    if (r && (all || (r >= seg[(int)old] && r < seg[(int)old] + SEG_SIZE))) {
+      unsigned char *dst = seg[(int)next] + headOff;
+      flash_write(dst, r, r[1] + OVERHEAD);	// crc and all
+      latest[(int)t] = dst;
+      headOff += r[1] + OVERHEAD;
+    }
+  }
+  seq[(int)next] = seq_next(seq[(int)head]);
+  hdr[0] = seq[(int)next];
+  hdr[1] = seq[(int)next] >> 8;
+  flash_write(seg[(int)next], hdr, HEADER);
+  head = next;
+}
+
+// replay the records of segment s into latest[]; returns the first
+// free offset
+static unsigned char
+replay(char s)
+{
+  unsigned char off = HEADER;
+  while (off + OVERHEAD <= SEG_SIZE) {
+    const unsigned char *r = seg[(int)s] + off;
+    if (r[0] == ERASED)
+      break;
+    if (off + r[1] + OVERHEAD > SEG_SIZE)
+      return SEG_SIZE;			// torn header: treat the segment as full
+    if (r[0] < FLASH_TAGS && record_ok(r))
+      latest[r[0]] = r[1] ? r : 0;
+    off += r[1] + OVERHEAD;
+  }
+  return off;
+}
+
+// --------------------------------------------------
+// API
+// --------------------------------------------------
+
+// Find the head and replay the log (the segment before the head, if
+// the head follows it, then the head) so latest[] ends up pointing at
+// the newest records.  The head is the segment that follows its
+// predecessor and is not followed in turn; a lone segment only counts
+// if there is no such pair (a new log), so a segment whose erase was
+// cut short, whatever its header reads, does not take over.
+void flashStoreInit()
+{
+  char s;
+
+  head = -1;
+  for (s = 0; s < SEGMENTS; s++)
+    seq[(int)s] = seg[(int)s][0] | (seg[(int)s][1] << 8);
+  for (s = 0; s < SEGMENTS; s++)
+    if (follows(s) && !follows((s + 1) % SEGMENTS))
+      head = s;
+  for (s = 0; head < 0 && s < SEGMENTS; s++)
+    if (seq[(int)s] != 0xffff)
+      head = s;
+  for (s = 0; s < FLASH_TAGS; s++)
+    latest[(int)s] = 0;
+  if (head < 0) {			// blank info memory: start the log in D
+    head = SEGMENTS - 1;
+    seq[(int)head] = 0xfffe;		// so that D gets sequence 0
+    advance(0);
+    return;
+  }
+
+  if (follows(head))
+    replay((head + SEGMENTS - 1) % SEGMENTS);
+  headOff = replay(head);
+}
+
+// copy the newest version of tag into buf; returns its length (0: none)
+unsigned char flashStoreRead(unsigned char tag, void *buf, unsigned char size)
+{
+  const unsigned char *r = tag < FLASH_TAGS ? latest[tag] : 0;
+  unsigned char len;
+
+  if (!r)
+    return 0;
+  len = r[1] < size ? r[1] : size;
+  memcpy(buf, r + 2, len);
+  return len;
+}
+
+// append a new version of tag (len 0 deletes it); 0 if it cannot fit.
+// The current records may be split over both log segments so that no
+// advance leaves room for a big one: the second advance then gathers
+// them all in one segment (if they fit), and the third starts an empty
+// head after it.
+char flashStoreWrite(unsigned char tag, const void *data, unsigned char len)
+{
+  if (tag >= FLASH_TAGS || len > FLASH_MAX_DATA)
+    return 0;
+  for (char tries = 0; headOff + len + OVERHEAD > SEG_SIZE; tries++) {
+    if (tries == SEGMENTS)
+      return 0;				// live records fill the whole log
+    advance(tries == 1 && HEADER + live() <= SEG_SIZE);
+  }
+  append(tag, data, len);
+  return 1;
+}
@@ -0,0 +1,26 @@
+#ifndef flashStore_included
+#define flashStore_included
+
+// Small persistent store in the G2553 information memory.  Segments
+// D, C and B (64 bytes each; A holds the DCO calibration and is never
+// touched) form a circular log of append-only records:
+//
+//   segment: seq (2 bytes, 0xffff = erased), records...
+//   record:  tag, len, data[len], crc16 (LSB first)
+//
+// A write appends a new version of a tag; the newest record with a
+// good CRC wins, and len 0 deletes the tag.  The log spans two
+// segments and the third is kept spare: when the head is full, the
+// records of the older segment that are still current are copied to
+// the spare, which then becomes the head (so erases rotate over all
+// three).  The older segment is only erased the next time round, so a
+// reset at any point keeps every record but the one being written.
+
+#define FLASH_TAGS      4	// tags 0..FLASH_TAGS-1
+#define FLASH_MAX_DATA  58	// largest record that fits a segment
+
+void flashStoreInit();		// boot-time scan; call before the others
+unsigned char flashStoreRead(unsigned char tag, void *buf, unsigned char size);
+char flashStoreWrite(unsigned char tag, const void *data, unsigned char len);
+
+#endif
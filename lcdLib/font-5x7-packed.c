@@ -0,0 +1,44 @@
+/* font_5x7 subset generated by fontgen:
+   !"#$%&'()*+,-./0123456789:;<=>?@ABCDEFGHIJKLMNOPQRSTUVWXYZ[\]^_`abcdefghijklmnopqrstuvwxyz{|}~
+*/
+#include "lcdutils.h"
+
+static const u_char glyphBits[] = {
+  0x00, 0xc0, 0x17, 0x00, 0x00, 0x1c, 0x00, 0x07, 0x00, 0xe5, 0x4f, 0xf9,
+  0x53, 0x48, 0xaa, 0xbf, 0x4a, 0x32, 0x9a, 0x20, 0xc8, 0x62, 0x5b, 0xb2,
+  0x2a, 0x82, 0x02, 0x0a, 0x03, 0x00, 0x00, 0xc0, 0x11, 0x05, 0x01, 0x80,
+  0xa0, 0x88, 0x03, 0xa0, 0x20, 0x7c, 0x08, 0x0a, 0x02, 0xe1, 0x43, 0x20,
+  0x00, 0x50, 0x18, 0x00, 0x80, 0x40, 0x20, 0x10, 0x08, 0x00, 0x18, 0x0c,
+  0x00, 0x80, 0x20, 0x08, 0x82, 0xc0, 0x17, 0x4d, 0x16, 0x7d, 0x00, 0xe1,
+  0x1f, 0x08, 0x10, 0x86, 0xa3, 0x49, 0x63, 0x28, 0x58, 0x5c, 0xc6, 0x30,
+  0x14, 0xc9, 0x1f, 0x72, 0x2a, 0x16, 0x8b, 0x39, 0x9e, 0x32, 0x99, 0x84,
+  0x05, 0xe2, 0x89, 0xc2, 0xc0, 0x96, 0x4c, 0x26, 0x6d, 0x86, 0x64, 0x32,
+  0xe5, 0x01, 0xd8, 0x6c, 0x00, 0x00, 0xc0, 0x6a, 0x03, 0x00, 0x10, 0x14,
+  0x51, 0x10, 0x40, 0xa1, 0x50, 0x28, 0x14, 0x40, 0x50, 0x44, 0x41, 0x08,
+  0x02, 0xd1, 0x84, 0x41, 0x96, 0xcc, 0x07, 0x7d, 0xfe, 0x48, 0x24, 0xe2,
+  0xff, 0x27, 0x93, 0x49, 0x9b, 0x2f, 0x18, 0x0c, 0x8a, 0xfe, 0xc1, 0xa0,
+  0x88, 0xf3, 0x4f, 0x26, 0x93, 0xc1, 0x7f, 0x22, 0x91, 0x08, 0xf8, 0x82,
+  0xc9, 0xa4, 0xfe, 0x8f, 0x40, 0x20, 0xfe, 0x80, 0xe0, 0x3f, 0x08, 0x00,
+  0x01, 0x83, 0xbf, 0xc0, 0x1f, 0x41, 0x11, 0x05, 0xff, 0x40, 0x20, 0x10,
+  0xf8, 0x17, 0x30, 0x04, 0xff, 0x3f, 0x01, 0x01, 0xf9, 0xfb, 0x82, 0xc1,
+  0xa0, 0xef, 0x9f, 0x48, 0x24, 0x0c, 0xbe, 0x60, 0x34, 0xe4, 0xfd, 0x27,
+  0x32, 0x29, 0xa3, 0x31, 0x99, 0x4c, 0xc6, 0x02, 0x81, 0x7f, 0x20, 0xf0,
+  0x03, 0x02, 0x81, 0xbf, 0x0f, 0x08, 0x08, 0xfa, 0xfc, 0x80, 0x38, 0xe0,
+  0x6f, 0x4c, 0x41, 0x50, 0xc6, 0x07, 0x04, 0x1c, 0x71, 0x08, 0x47, 0x93,
+  0xc5, 0x21, 0xe0, 0x1f, 0x0c, 0x02, 0x04, 0x04, 0x04, 0x04, 0x04, 0x08,
+  0x06, 0xff, 0x00, 0x82, 0x20, 0x20, 0x20, 0x00, 0x81, 0x40, 0x20, 0x10,
+  0x10, 0x10, 0x10, 0x00, 0x20, 0x2a, 0x95, 0x8a, 0xff, 0x23, 0x89, 0x44,
+  0x1c, 0x8e, 0x48, 0x24, 0x82, 0x70, 0x44, 0x22, 0xf2, 0x8f, 0xa3, 0x52,
+  0xa9, 0x18, 0x84, 0x3f, 0x11, 0x10, 0x30, 0xa4, 0x52, 0xa9, 0xef, 0x8f,
+  0x20, 0x10, 0xf0, 0x00, 0x62, 0x1f, 0x08, 0x00, 0x01, 0x89, 0x3d, 0xc0,
+  0x1f, 0x82, 0x22, 0x02, 0x00, 0xc1, 0x3f, 0x10, 0xc0, 0x27, 0x60, 0x08,
+  0x78, 0x3e, 0x82, 0x40, 0xc0, 0xe3, 0x88, 0x44, 0x22, 0x8e, 0x4f, 0xa1,
+  0x50, 0x10, 0x08, 0x0a, 0x05, 0xc3, 0xe7, 0x23, 0x08, 0x04, 0x04, 0x92,
+  0x4a, 0xa5, 0x82, 0x08, 0x3f, 0x22, 0x10, 0xc4, 0x03, 0x02, 0x41, 0x7c,
+  0x0e, 0x08, 0x08, 0xe2, 0xf0, 0x80, 0x30, 0x20, 0x8f, 0x88, 0x82, 0xa0,
+  0x88, 0x0c, 0x28, 0x14, 0xca, 0x23, 0x92, 0xa9, 0x4c, 0x22, 0x00, 0x61,
+  0x0b, 0x02, 0x00, 0x80, 0x3f, 0x00, 0x00, 0x08, 0xda, 0x10, 0x00, 0x08,
+  0x02, 0x01, 0x41, 0x00, 0x0c, 0x89, 0x84, 0x01,
+};
+
+const Font5x7 font5x7 = { 0x21, 0x7f, 0, glyphBits };
@@ -0,0 +1,167 @@
+/** \file fontgen.c
+ *  \brief Host tool: subset and bit-pack font_5x7 for an application
+ *
+ *  Writes a C file defining font5x7 (see lcdutils.h) with only the
+ *  characters an application prints, 35 bits each.  Linked before
+ *  libLcd.a, it replaces the library's full copy (font-5x7-packed.c).
+ *
+ *    fontgen [-a] [-c chars] [file.c ...] > font5x7.c
+ *
+ *  -a takes every character, -c adds the given ones and each file
+ *  adds the characters of its string and character literals (comments
+ *  and preprocessor lines are skipped).  Text built at run time, such
+ *  as digits or what lcdformat's conversions (%5u) print, has to be
+ *  listed with -c.
+ */
+#include <stdio.h>
+#include <string.h>
+#include "lcdutils.h"
+
+#define FIRST_CHAR 0x20
+#define NUM_CHARS  96
+
+static u_char wanted[NUM_CHARS];
+
+/** Mark a character as used (only those the font has) */
+static void
+want(int c)
+{
+  if (c >= FIRST_CHAR && c < FIRST_CHAR + NUM_CHARS)
+    wanted[c - FIRST_CHAR] = 1;
+}
+
+/** Value of the escape sequence after a backslash */
+static int
+escape(FILE *f)
+{
+  int c = getc(f);
+  switch (c) {
+  case 'n': return '\n';
+  case 't': return '\t';
+  case '0': return 0;
+  default: return c;		/**< \\ \" \' and the rest: taken as is */
+  }
+}
+
+/** Add the characters of every literal in a C source file */
+static int
+scan(const char *name)
+{
+  FILE *f = fopen(name, "r");
+  int c, prev = '\n';
+
+  if (!f) {
+    perror(name);
+    return 0;
+  }
+  while ((c = getc(f)) != EOF) {
+    if (c == '#' && prev == '\n') {	/**< preprocessor line */
+      while ((c = getc(f)) != EOF && c != '\n')
+	;
+    } else if (c == '/') {
+      int next = getc(f);
+      if (next == '/') {
+	while ((c = getc(f)) != EOF && c != '\n')
+	  ;
+      } else if (next == '*') {
+	int last = 0;
+	while ((c = getc(f)) != EOF && !(last == '*' && c == '/'))
+	  last = c;
+      } else {
+	ungetc(next, f);
+      }
+    } else if (c == '"' || c == '\'') {
+      int quote = c;
+      while ((c = getc(f)) != EOF && c != quote && c != '\n') {
+	if (c == '%' && quote == '"') {	/**< lcdformat conversion */
+	  while ((c = getc(f)) >= '0' && c <= '9')
+	    ;
+	  if (c == '%')
+	    want(c);
+	  else if (c == EOF || c == quote)
+	    break;
+	} else {
+	  want(c == '\\' ? escape(f) : c);
+	}
+      }
+    }
+    if (c != ' ' && c != '\t')
+      prev = c;
+  }
+  fclose(f);
+  return 1;
+}
+
+/** Append one bit to the packed glyphs */
+static void
+put_bit(u_char *bits, u_int *pos, int bit)
+{
+  if (bit)
+    bits[*pos >> 3] |= 1 << (*pos & 7);
+  (*pos)++;
+}
+
+int
+main(int argc, char **argv)
+{
+  static u_char bits[NUM_CHARS * 35 / 8 + 1];
+  u_char glyph[NUM_CHARS];
+  u_int pos = 0;
+  int i, c, col, row, first = -1, last = -1, count = 0;
+
+  for (i = 1; i < argc; i++) {
+    if (!strcmp(argv[i], "-a")) {
+      memset(wanted, 1, sizeof wanted);
+    } else if (!strcmp(argv[i], "-c") && i + 1 < argc) {
+      const char *s;
+      for (s = argv[++i]; *s; s++)
+	want((u_char)*s);
+    } else if (argv[i][0] == '-' || !scan(argv[i])) {
+      fprintf(stderr, "usage: %s [-a] [-c chars] [file.c ...] > font5x7.c\n", argv[0]);
+      return 1;
+    }
+  }
+  wanted[0] = 0;		/**< a missing character is drawn as a space */
+
+  for (i = 0; i < NUM_CHARS; i++) {
+    if (!wanted[i])
+      continue;
+    if (first < 0)
+      first = i;
+    last = i;
+    glyph[i] = count++;
+    for (col = 0; col < 5; col++)
+      for (row = 0; row < 7; row++)
+	put_bit(bits, &pos, font_5x7[i][col] & (1 << row));
+  }
+  if (first < 0)		/**< nothing printed: one blank glyph */
+    first = last = 0;
+
+  printf("/* font_5x7 subset generated by fontgen:\n   ");
+  for (i = 0, c = 0; i < NUM_CHARS; i++) {
+    if (!wanted[i])
+      continue;
+    if (i + FIRST_CHAR == '/' && c == '*')
+      putchar(' ');		/**< do not close the comment */
+    putchar(c = i + FIRST_CHAR);
+  }
+  printf("\n*/\n#include \"lcdutils.h\"\n\n");
+
+  if (count != last - first + 1) {
+    printf("static const u_char glyphIndex[] = {");
+    for (i = first; i <= last; i++)
+      printf("%s%u,", (i - first) % 16 ? " " : "\n  ",
+	     wanted[i] ? glyph[i] : FONT_MISSING);
+    printf("\n};\n\n");
+  }
+  printf("static const u_char glyphBits[] = {");
+  for (i = 0; i < (int)(pos + 7) / 8 || i == 0; i++)
+    printf("%s0x%02x,", i % 12 ? " " : "\n  ", bits[i]);
+  printf("\n};\n\n");
+  printf("const Font5x7 font5x7 = { 0x%02x, 0x%02x, %s, glyphBits };\n",
+	 first + FIRST_CHAR, last + FIRST_CHAR,
+	 count != last - first + 1 ? "glyphIndex" : "0");
+  fprintf(stderr, "%d glyphs, %u bytes\n", count,
+	  (pos + 7) / 8 + (count != last - first + 1 ? last - first + 1 : 0));
+  return 0;
+}
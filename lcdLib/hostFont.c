@@ -0,0 +1,88 @@
+/** \file hostFont.c
+ *  \brief Host check: the packed font draws as font_5x7
+ *
+ *    hostFont
+ *
+ *  Draws every character with drawChar5x7, drawChar5x7Scaled (scales
+ *  1 to 3) and drawChar5x7Transparent and compares the whole screen
+ *  with the glyph painted from font_5x7.  Built with FONT_SUBSET set to
+ *  the characters a fontgen subset holds (hostFontSubset), the others
+ *  must come out blank.
+ */
+#include <stdio.h>
+#include <string.h>
+#include "lcdutils.h"
+#include "lcddraw.h"
+#include "hostScreen.h"
+
+#define COL 3			/**< where glyphs are drawn */
+#define ROW 5
+#define FG  0x1111
+#define BG  0x2222
+#define OLD 0x5555		/**< screen before the draw */
+
+static u_int expected[screenHeight][screenWidth];
+
+/** Is character c in the font under test? */
+static int
+in_font(int c)
+{
+#ifdef FONT_SUBSET
+  return c != ' ' && strchr(FONT_SUBSET, c) != 0;
+#else
+  return 1;
+#endif
+}
+
+/** Expected screen: character c at scale; bgColorBGR OLD if transparent */
+static void
+paint(int c, int scale, u_int bgColorBGR)
+{
+  int x, y;
+  for (y = 0; y < screenHeight; y++)
+    for (x = 0; x < screenWidth; x++)
+      expected[y][x] = OLD;
+  for (y = 0; y < 8 * scale; y++)
+    for (x = 0; x < 5 * scale; x++)
+      expected[ROW + y][COL + x] =
+	in_font(c) && font_5x7[c - 0x20][x / scale] >> (y / scale) & 1 ? FG : bgColorBGR;
+}
+
+/** Count a mismatch and say where */
+static int
+check(const char *what, int c, int scale)
+{
+  if (!memcmp(expected, screen, sizeof expected))
+    return 0;
+  printf("%s '%c' x%d differs\n", what, c, scale);
+  return 1;
+}
+
+int
+main()
+{
+  int c, scale, bad = 0, chars = 0;
+
+  for (c = 0x20; c < 0x80; c++) {
+    chars += in_font(c);
+
+    paint(c, 1, BG);
+    screenFill(OLD);
+    drawChar5x7(COL, ROW, c, FG, BG);
+    bad += check("drawChar5x7", c, 1);
+
+    for (scale = 1; scale <= 3; scale++) {
+      paint(c, scale, BG);
+      screenFill(OLD);
+      drawChar5x7Scaled(COL, ROW, c, scale, FG, BG);
+      bad += check("drawChar5x7Scaled", c, scale);
+    }
+
+    paint(c, 1, OLD);
+    screenFill(OLD);
+    drawChar5x7Transparent(COL, ROW, c, FG);
+    bad += check("drawChar5x7Transparent", c, 1);
+  }
+  printf("%d characters in the font, %d draws differ\n", chars, bad);
+  return bad != 0;
+}
@@ -0,0 +1,113 @@
+/** \file hostList.c
+ *  \brief Host check: a display list draws what direct drawing draws
+ *
+ *    hostList [frames]
+ *
+ *  Each frame is a random mix of fills (cell-aligned and not), glyphs,
+ *  outlines and images, drawn once directly and once through a list
+ *  too small to hold it (so it flushes on the way).  The two screens
+ *  must match; the windows and pixels each way sent are reported.
+ */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "lcdutils.h"
+#include "lcddraw.h"
+#include "lcdlist.h"
+#include "hostScreen.h"
+
+#define MAX_OPS  30		/**< draws per frame */
+#define LIST_OPS 12		/**< display list size */
+
+/** One draw of a frame */
+typedef struct {
+  u_char kind;			/**< 0 glyph, 1 image, 2 outline, else fill */
+  u_char col, row, width, height, color;
+} Draw;
+
+static u_int direct[screenHeight][screenWidth];
+static u_int image[8 * 8];
+
+/** A random frame of n draws, all on screen */
+static void
+make_frame(Draw *d, int n)
+{
+  for (; n--; d++) {
+    d->kind = rand() % 8;
+    d->col = (rand() % 16) * 8;
+    d->row = (rand() % 20) * 8;
+    d->width = 8 * (1 + rand() % 3);
+    d->height = 8 * (1 + rand() % 2);
+    d->color = rand() % 3;
+    if (d->kind > 2 && rand() % 3 == 0) { /**< a fill off the cell grid */
+      d->col += rand() % 8;
+      d->width = 1 + rand() % 12;
+    }
+    if (d->col + d->width > screenWidth)
+      d->width = screenWidth - d->col;
+    if (d->row + d->height > screenHeight)
+      d->height = screenHeight - d->row;
+  }
+}
+
+static void
+draw_frame(const Draw *d, int n)
+{
+  for (; n--; d++) {
+    switch (d->kind) {
+    case 0:
+      drawChar5x7(d->col, d->row, 'A' + d->color, 1, 2);
+      break;
+    case 1:
+      drawImage(d->col, d->row, 8, 8, image);
+      break;
+    case 2:
+      drawRectOutline(d->col, d->row, 7, 7, d->color);
+      break;
+    default:
+      fillRectangle(d->col, d->row, d->width, d->height, d->color);
+    }
+  }
+}
+
+int
+main(int argc, char **argv)
+{
+  long frames = argc > 1 ? atol(argv[1]) : 20000, t;
+  unsigned long windows[2] = {0, 0}, pixels[2] = {0, 0};
+  long bad = 0;
+  Draw frame[MAX_OPS];
+  DlOp list[LIST_OPS];
+  int i, n;
+
+  srand(3);
+  for (i = 0; i < 8 * 8; i++)
+    image[i] = i * 77;
+
+  for (t = 0; t < frames; t++) {
+    n = 1 + rand() % MAX_OPS;
+    make_frame(frame, n);
+
+    screenFill(0xeeee);
+    windows[0] -= screenWindows;
+    pixels[0] -= screenPixels;
+    draw_frame(frame, n);
+    windows[0] += screenWindows;
+    pixels[0] += screenPixels;
+    memcpy(direct, screen, sizeof direct);
+
+    screenFill(0xeeee);
+    windows[1] -= screenWindows;
+    pixels[1] -= screenPixels;
+    dlBegin(list, LIST_OPS);
+    draw_frame(frame, n);
+    dlEnd();
+    windows[1] += screenWindows;
+    pixels[1] += screenPixels;
+    if (memcmp(direct, screen, sizeof direct))
+      bad++;
+  }
+  printf("%ld frames, %ld differ; windows %lu -> %lu, pixels %lu -> %lu\n",
+	 frames, bad, windows[0], windows[1], pixels[0], pixels[1]);
+  return bad != 0;
+}
@@ -0,0 +1,77 @@
+/** \file hostMove.c
+ *  \brief Host check: moveRectangle and moveMask match erase and redraw
+ *
+ *    hostMove [moves]
+ *
+ *  Each move draws a random rectangle or 16-bit-wide mask, moves it by
+ *  up to 4 pixels each way and compares the screen with the object
+ *  erased at its old position and drawn at the new one.  The pixels
+ *  sent are reported against what erase and redraw would send.
+ */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "lcdutils.h"
+#include "lcddraw.h"
+#include "lcdmove.h"
+#include "hostScreen.h"
+
+#define FG 7			/**< object color */
+#define BG 0			/**< background */
+
+static u_int expected[screenHeight][screenWidth];
+
+/** Paint a mask into a framebuffer, lit pixels only */
+static void
+put_mask(u_int fb[][screenWidth], int col, int row, int width, int height,
+	 const u_int *mask, u_int colorBGR)
+{
+  int x, y;
+  for (y = 0; y < height; y++)
+    for (x = 0; x < width; x++)
+      if (mask[y] >> x & 1)
+	fb[row + y][col + x] = colorBGR;
+}
+
+int
+main(int argc, char **argv)
+{
+  long moves = argc > 1 ? atol(argv[1]) : 200000, t, bad = 0;
+  unsigned long sent = 0, redraw = 0;
+  u_int mask[16], full[16];
+  int i;
+
+  srand(1);
+  for (t = 0; t < moves; t++) {
+    int width = 1 + rand() % 16, height = 1 + rand() % 16;
+    int col = 20 + rand() % 60, row = 20 + rand() % 60;
+    int dx = rand() % 9 - 4, dy = rand() % 9 - 4;
+    int isRect = t & 1;
+
+    for (i = 0; i < height; i++) {
+      mask[i] = rand() & 0xffff;
+      full[i] = 0xffff;
+    }
+    if (isRect)
+      memcpy(mask, full, sizeof mask);
+
+    screenFill(BG);
+    put_mask(screen, col, row, width, height, mask, FG);
+    memcpy(expected, screen, sizeof expected);
+    put_mask(expected, col, row, width, height, mask, BG);
+    put_mask(expected, col + dx, row + dy, width, height, mask, FG);
+
+    screenPixels = 0;
+    if (isRect)
+      moveRectangle(col, row, width, height, dx, dy, FG, BG);
+    else
+      moveMask(col, row, width, height, mask, dx, dy, FG, BG);
+    sent += screenPixels;
+    redraw += 2 * width * height;
+    if (memcmp(expected, screen, sizeof expected))
+      bad++;
+  }
+  printf("%ld moves, %ld differ; pixels %lu (erase and redraw: %lu)\n",
+	 moves, bad, sent, redraw);
+  return bad != 0;
+}
@@ -0,0 +1,51 @@
+/** \file hostScreen.c
+ *  \brief Host checks: an LCD made of a framebuffer in RAM
+ */
+#include <stdio.h>
+#include <stdlib.h>
+#include "lcdutils.h"
+#include "hostScreen.h"
+
+u_int screen[screenHeight][screenWidth];
+unsigned long screenWindows, screenPixels;
+
+static u_char areaColStart, areaColEnd, areaRowEnd;	/**< the window */
+static u_char col, row;			/**< next pixel in it */
+
+void
+lcd_setArea(u_char colStart, u_char rowStart, u_char colEnd, u_char rowEnd)
+{
+  if (colEnd >= screenWidth || rowEnd >= screenHeight ||
+      colStart > colEnd || rowStart > rowEnd) {
+    fprintf(stderr, "bad window %u,%u..%u,%u\n", colStart, rowStart, colEnd, rowEnd);
+    exit(2);
+  }
+  areaColStart = col = colStart;
+  areaColEnd = colEnd;
+  row = rowStart;
+  areaRowEnd = rowEnd;
+  screenWindows++;
+}
+
+void
+lcd_writeColor(u_int colorBGR)
+{
+  if (row > areaRowEnd) {
+    fprintf(stderr, "pixel past the window\n");
+    exit(2);
+  }
+  screen[row][col] = colorBGR;
+  screenPixels++;
+  if (++col > areaColEnd) {
+    col = areaColStart;
+    row++;
+  }
+}
+
+void
+screenFill(u_int colorBGR)
+{
+  u_int i, *p = &screen[0][0];
+  for (i = 0; i < screenWidth * screenHeight; i++)
+    p[i] = colorBGR;
+}
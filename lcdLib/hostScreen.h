@@ -0,0 +1,27 @@
+/** \file hostScreen.h
+ *  \brief Host checks: an LCD made of a framebuffer in RAM
+ *
+ *  hostScreen.c defines lcd_setArea and lcd_writeColor for a native
+ *  (Linux) build of the drawing code: pixels land in screen[][] and
+ *  every window and pixel sent is counted, so a check can compare two
+ *  ways of drawing the same thing and what each costs on the SPI bus.
+ */
+
+#ifndef hostScreen_included
+#define hostScreen_included
+
+#include "lcdutils.h"
+
+/** What the LCD shows, [row][col] */
+extern u_int screen[screenHeight][screenWidth];
+
+extern unsigned long screenWindows;	/**< lcd_setArea calls */
+extern unsigned long screenPixels;	/**< lcd_writeColor calls */
+
+/** Set every pixel to colorBGR without counting it
+ *
+ *  \param colorBGR Color in BGR
+ */
+void screenFill(u_int colorBGR);
+
+#endif // included
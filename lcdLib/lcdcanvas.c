@@ -0,0 +1,120 @@
+/** \file lcdcanvas.c
+ *  \brief Off-screen canvas: compose a small region in RAM, send it once
+ */
+#include "lcdutils.h"
+#include "lcddraw.h"
+#include "lcdlist.h"
+#include "lcdcanvas.h"
+
+static Canvas *active;		/**< canvas being drawn into */
+static void (*outerRecord)(const DlOp *op);	/**< display list around it */
+
+/** Palette index of a color, added if there is room (private) */
+static u_char
+canvas_index(Canvas *cv, u_int colorBGR)
+{
+  u_char i;
+  for (i = 0; i < cv->colors; i++)
+    if (cv->palette[i] == colorBGR)
+      return i;
+  if (cv->colors == 1 << cv->bpp)
+    return 0;			/**< palette full: background */
+  cv->palette[cv->colors] = colorBGR;
+  return cv->colors++;
+}
+
+/** Set canvas pixel x,y (canvas coordinates) to index (private) */
+static void
+canvas_put(Canvas *cv, u_char x, u_char y, u_char index)
+{
+  u_int bit = (y * cv->width + x) * cv->bpp;
+  u_char shift = bit & 7, mask = ((1 << cv->bpp) - 1) << shift;
+  u_char *p = &cv->pixels[bit >> 3];
+  *p = (*p & ~mask) | (index << shift);
+}
+
+/** Draw one op into the active canvas, clipped (private)
+ *
+ *  Installed as the display list's recording hook, so every primitive
+ *  that can be recorded can also draw here.
+ */
+static void
+canvas_record(const DlOp *op)
+{
+  Canvas *cv = active;
+  u_char col0 = op->col > cv->col ? op->col : cv->col;
+  u_char row0 = op->row > cv->row ? op->row : cv->row;
+  u_int colEnd = op->col + op->width, rowEnd = op->row + op->height;
+  u_char scale = op->width / 5, glyph[5], fg = 0, bg = 0;
+  u_char col, row;
+
+  if (colEnd > cv->col + cv->width) colEnd = cv->col + cv->width;
+  if (rowEnd > cv->row + cv->height) rowEnd = cv->row + cv->height;
+  if (col0 >= colEnd || row0 >= rowEnd)
+    return;
+
+  switch (op->kind) {
+  case DL_FILL:
+    fg = canvas_index(cv, op->color);
+    break;
+  case DL_CHAR:
+    font5x7Glyph(op->c, glyph);
+    fg = canvas_index(cv, op->color);
+    bg = canvas_index(cv, op->u.bg);
+    break;
+  case DL_IMAGE:
+    break;
+  default:
+    return;
+  }
+
+  for (row = row0; row < rowEnd; row++) {
+    for (col = col0; col < colEnd; col++) {
+      u_char x = col - op->col, y = row - op->row, index = fg;
+      if (op->kind == DL_CHAR)
+	index = (glyph[x / scale] >> (y / scale)) & 1 ? fg : bg;
+      else if (op->kind == DL_IMAGE)
+	index = canvas_index(cv, op->u.pixels[y * op->width + x]);
+      canvas_put(cv, col - cv->col, row - cv->row, index);
+    }
+  }
+}
+
+void
+canvasBegin(Canvas *canvas, u_int bgColorBGR)
+{
+  u_int i, n = CANVAS_BYTES(canvas->width, canvas->height, canvas->bpp);
+  for (i = 0; i < n; i++)
+    canvas->pixels[i] = 0;
+  canvas->palette[0] = bgColorBGR;
+  canvas->colors = 1;
+  active = canvas;
+  outerRecord = lcd_dlRecord;
+  lcd_dlRecord = canvas_record;
+}
+
+void
+canvasEnd(Canvas *canvas)
+{
+  u_int n = canvas->width * canvas->height;
+  const u_char *p = canvas->pixels;
+  u_char mask = (1 << canvas->bpp) - 1, shift = 0;
+
+  lcd_dlRecord = outerRecord;
+  if (outerRecord) {		/**< draw what the list holds, then us */
+    dlFlush();
+    lcd_dlRecord = 0;
+  }
+  lcd_setArea(canvas->col, canvas->row,
+	      canvas->col + canvas->width - 1, canvas->row + canvas->height - 1);
+  while (n--) {
+    lcd_writeColor(canvas->palette[(*p >> shift) & mask]);
+    shift += canvas->bpp;
+    if (shift == 8) {
+      shift = 0;
+      p++;
+    }
+  }
+  lcd_dlRecord = outerRecord;
+  active = 0;
+}
@@ -0,0 +1,59 @@
+/** \file lcdcanvas.h
+ *  \brief Off-screen canvas: compose a small region in RAM, send it once
+ *
+ *  Between canvasBegin and canvasEnd, fillRectangle, drawPixel,
+ *  drawRectOutline, the 5x7 text calls (plain, scaled, transparent and
+ *  formatted), drawImage and lcdshapes' lines and shapes draw into the
+ *  canvas instead of the LCD, clipped to its rectangle.  canvasEnd then
+ *  sends the whole rectangle in one window, each pixel once: no
+ *  overdraw, so no flicker from layered draws.
+ *
+ *  Pixels are palette indexes packed at 1, 2 or 4 bits; the palette is
+ *  filled with the colors as they are first drawn.  The caller owns
+ *  both buffers, so a canvas can live on the stack: a 16x16 canvas at
+ *  2 bits is 64 bytes, 32x32 at 2 bits 256.
+ *
+ *  Like a display list, the canvas catches every draw until canvasEnd,
+ *  interrupt handlers' too: if handlers draw, keep interrupts off from
+ *  canvasBegin to canvasEnd.
+ */
+
+#ifndef lcdcanvas_included
+#define lcdcanvas_included
+
+#include "lcdutils.h"
+
+/** Pixel buffer size for a width x height canvas at bpp bits per pixel */
+#define CANVAS_BYTES(width, height, bpp) (((width) * (height) * (bpp) + 7) / 8)
+
+/** A canvas */
+typedef struct {
+  u_char col, row;		/**< screen position */
+  u_char width, height;
+  u_char bpp;			/**< bits per pixel: 1, 2 or 4 */
+  u_char colors;		/**< palette entries in use */
+  u_int *palette;		/**< 1 << bpp BGR colors */
+  u_char *pixels;		/**< CANVAS_BYTES(width, height, bpp), row-major */
+} Canvas;
+
+/** Clear the canvas to bgColorBGR and send draws to it
+ *
+ *  Colors past the palette's size are drawn as the background (index 0).
+ *  Canvases do not nest; a canvas may be used inside a display list.
+ *
+ *  \param canvas The canvas (set col, row, width, height, bpp, palette
+ *  and pixels first)
+ *  \param bgColorBGR Background color in BGR (palette index 0)
+ */
+void canvasBegin(Canvas *canvas, u_int bgColorBGR);
+
+/** Stop drawing into the canvas and send it to the LCD in one window
+ *
+ *  Inside a display list, the ops recorded so far are flushed first, so
+ *  the canvas lands on top of them.
+ *
+ *  \param canvas The canvas
+ */
+void canvasEnd(Canvas *canvas);
+
+#endif // included
@@ -19,5 +19,7 @@ main()
   drawString5x7(20,20, "hello", COLOR_GREEN, COLOR_RED);
 
   fillRectangle(30,30, 60, 60, COLOR_ORANGE);
+
+  drawString5x7Scaled(20,100, "hello", 2, COLOR_WHITE, COLOR_BLUE);
   
 }
@@ -3,7 +3,10 @@
  */
 #include "lcdutils.h"
 #include "lcddraw.h"
+#include "lcdlist.h"
 
+/** Set by dlBegin: record draws in the display list instead */
+void (*lcd_dlRecord)(const DlOp *op) = 0;
 
 /** Draw single pixel at x,row 
  *
@@ -13,6 +16,11 @@
  */
 void drawPixel(u_char col, u_char row, u_int colorBGR) 
 {
+  if (lcd_dlRecord) {
+    DlOp op = {col, row, 1, 1, DL_FILL, 0, colorBGR};
+    lcd_dlRecord(&op);
+    return;
+  }
   lcd_setArea(col, row, col, row);
   lcd_writeColor(colorBGR);
 }
@@ -28,6 +36,11 @@ void drawPixel(u_char col, u_char row, u_int colorBGR)
 void fillRectangle(u_char colMin, u_char rowMin, u_char width, u_char height, 
 		   u_int colorBGR)
 {
+  if (lcd_dlRecord) {
+    DlOp op = {colMin, rowMin, width, height, DL_FILL, 0, colorBGR};
+    lcd_dlRecord(&op);
+    return;
+  }
   u_char colLimit = colMin + width, rowLimit = rowMin + height;
   lcd_setArea(colMin, rowMin, colLimit - 1, rowLimit - 1);
   u_int total = width * height;
@@ -48,6 +61,28 @@ void clearScreen(u_int colorBGR)
   fillRectangle(0, 0, screenWidth, screenHeight, colorBGR);
 }
 
+/** Unpack character c of font5x7 into one byte per column, bit =
+ *  row; characters the font lacks come out blank
+ */
+void font5x7Glyph(char c, u_char *glyph)
+{
+  u_char i = c, col, bit;
+  u_int pos;
+
+  for (col = 0; col < 5; col++)
+    glyph[col] = 0;
+  if (i < font5x7.first || i > font5x7.last)
+    return;
+  i -= font5x7.first;
+  if (font5x7.index && (i = font5x7.index[i]) == FONT_MISSING)
+    return;
+  pos = i * 35;
+  for (col = 0; col < 5; col++)
+    for (bit = 0x01; bit < 0x80; bit <<= 1, pos++)
+      if (font5x7.bits[pos >> 3] & (1 << (pos & 7)))
+	glyph[col] |= bit;
+}
+
 /** 5x7 font - this function draws background pixels
  *  Adapted from RobG's EduKit
  */
@@ -57,12 +92,18 @@ void drawChar5x7(u_char rcol, u_char rrow, char c,
   u_char col = 0;
   u_char row = 0;
   u_char bit = 0x01;
-  u_char oc = c - 0x20;
+  u_char glyph[5];
 
+  if (lcd_dlRecord) {
+    DlOp op = {rcol, rrow, 5, 8, DL_CHAR, c, fgColorBGR, {bgColorBGR}};
+    lcd_dlRecord(&op);
+    return;
+  }
+  font5x7Glyph(c, glyph);
   lcd_setArea(rcol, rrow, rcol + 4, rrow + 7); /* relative to requested col/row */
   while (row < 8) {
     while (col < 5) {
-      u_int colorBGR = (font_5x7[oc][col] & bit) ? fgColorBGR : bgColorBGR;
+      u_int colorBGR = (glyph[col] & bit) ? fgColorBGR : bgColorBGR;
       lcd_writeColor(colorBGR);
       col++;
     }
@@ -72,6 +113,29 @@ void drawChar5x7(u_char rcol, u_char rrow, char c,
   }
 }
 
+/** Draw image (row-major BGR pixels) in one window
+ *
+ *  \param colMin Column start
+ *  \param rowMin Row start
+ *  \param width Width of image
+ *  \param height Height of image
+ *  \param pixels width*height colors in BGR
+ */
+void drawImage(u_char colMin, u_char rowMin, u_char width, u_char height,
+	       const u_int *pixels)
+{
+  if (lcd_dlRecord) {
+    DlOp op = {colMin, rowMin, width, height, DL_IMAGE, 0, 0};
+    op.u.pixels = pixels;
+    lcd_dlRecord(&op);
+    return;
+  }
+  lcd_setArea(colMin, rowMin, colMin + width - 1, rowMin + height - 1);
+  u_int total = width * height;
+  while (total--)
+    lcd_writeColor(*pixels++);
+}
+
 /** Draw string at col,row
  *  Type:
  *  FONT_SM - small (5x8,) FONT_MD - medium (8x12,) FONT_LG - large (11x16)
@@ -94,6 +158,141 @@ void drawString5x7(u_char col, u_char row, char *string,
   }
 }
 
+/** 5x7 font scaled: each font pixel becomes a scale x scale block, all
+ *  in one window.  A font row is gathered once into a 5-bit mask and
+ *  sent scale times.
+ *
+ *  \param rcol Column to draw to
+ *  \param rrow Row to draw to
+ *  \param c The character
+ *  \param scale Block size of one font pixel (1 is drawChar5x7; 0 is
+ *  taken as 1)
+ *  \param fgColorBGR Foreground color in BGR
+ *  \param bgColorBGR Background color in BGR
+ */
+void drawChar5x7Scaled(u_char rcol, u_char rrow, char c, u_char scale,
+		       u_int fgColorBGR, u_int bgColorBGR)
+{
+  u_char glyph[5];
+  u_char bit, col, rowBits, rep, dup;
+
+  if (!scale)			/**< 0 would make the window wrap around */
+    scale = 1;
+  if (lcd_dlRecord) {		/**< the scale is kept in the op's width */
+    DlOp op = {rcol, rrow, 5 * scale, 8 * scale, DL_CHAR, c, fgColorBGR, {bgColorBGR}};
+    lcd_dlRecord(&op);
+    return;
+  }
+  font5x7Glyph(c, glyph);
+  lcd_setArea(rcol, rrow, rcol + 5 * scale - 1, rrow + 8 * scale - 1);
+  for (bit = 0x01; bit; bit <<= 1) {
+    for (rowBits = 0, col = 0; col < 5; col++)
+      if (glyph[col] & bit)
+	rowBits |= 1 << col;
+    for (rep = scale; rep; rep--) {
+      for (col = 0; col < 5; col++) {
+	u_int colorBGR = (rowBits >> col) & 1 ? fgColorBGR : bgColorBGR;
+	for (dup = scale; dup; dup--)
+	  lcd_writeColor(colorBGR);
+      }
+    }
+  }
+}
+
+/** Draw string scaled, see drawChar5x7Scaled
+ *
+ *  \param col Column to start drawing string
+ *  \param row Row to start drawing string
+ *  \param string The string
+ *  \param scale Block size of one font pixel (0 is taken as 1)
+ *  \param fgColorBGR Foreground color in BGR
+ *  \param bgColorBGR Background color in BGR
+ */
+void drawString5x7Scaled(u_char col, u_char row, char *string, u_char scale,
+			 u_int fgColorBGR, u_int bgColorBGR)
+{
+  if (!scale)
+    scale = 1;
+  while (*string) {
+    drawChar5x7Scaled(col, row, *string++, scale, fgColorBGR, bgColorBGR);
+    col += 6 * scale;
+  }
+}
+
+/** Number of runs of 1 bits in a mask, given the mask of its bits that
+ *  do not continue a run (private) */
+static u_char run_count(u_char starts)
+{
+  u_char n = 0;
+  for (; starts; starts &= starts - 1)
+    n++;
+  return n;
+}
+
+/** 5x7 font without background: the lit pixels are sent as vertical
+ *  or horizontal runs, whichever the glyph has fewer of, one fill each
+ *
+ *  \param rcol Column to draw to
+ *  \param rrow Row to draw to
+ *  \param c The character
+ *  \param fgColorBGR Foreground color in BGR
+ */
+void drawChar5x7Transparent(u_char rcol, u_char rrow, char c,
+			    u_int fgColorBGR)
+{
+  u_char glyph[5];
+  u_char col, row, start, bits, prev = 0;
+  u_char vRuns = 0, hRuns = 0;
+
+  font5x7Glyph(c, glyph);
+
+  for (col = 0; col < 5; col++) {  /**< a glyph column is one byte, bit = row */
+    vRuns += run_count(glyph[col] & ~(glyph[col] << 1));
+    hRuns += run_count(glyph[col] & ~prev);
+    prev = glyph[col];
+  }
+
+  if (vRuns <= hRuns) {
+    for (col = 0; col < 5; col++) {
+      for (bits = glyph[col], row = 0; bits; ) {
+	for (; !(bits & 1); bits >>= 1)
+	  row++;
+	for (start = row; bits & 1; bits >>= 1)
+	  row++;
+	fillRectangle(rcol + col, rrow + start, 1, row - start, fgColorBGR);
+      }
+    }
+  } else {
+    for (row = 0, bits = 0x01; row < 8; row++, bits <<= 1) {
+      for (col = 0; col < 5; ) {
+	if (!(glyph[col] & bits)) {
+	  col++;
+	  continue;
+	}
+	for (start = col; col < 5 && (glyph[col] & bits); col++)
+	  ;
+	fillRectangle(rcol + start, rrow + row, col - start, 1, fgColorBGR);
+      }
+    }
+  }
+}
+
+/** Draw string without background, see drawChar5x7Transparent
+ *
+ *  \param col Column to start drawing string
+ *  \param row Row to start drawing string
+ *  \param string The string
+ *  \param fgColorBGR Foreground color in BGR
+ */
+void drawString5x7Transparent(u_char col, u_char row, char *string,
+			      u_int fgColorBGR)
+{
+  while (*string) {
+    drawChar5x7Transparent(col, row, *string++, fgColorBGR);
+    col += 6;
+  }
+}
+
 
 /** Draw rectangle outline
  *  
@@ -50,6 +50,55 @@ void drawString5x7(u_char col, u_char row, char *string,
 void drawChar5x7(u_char col, u_char row, char c, 
 		 u_int fgColorBGR, u_int bgColorBGR);
 
+/** Draw string scaled: every font pixel is a scale x scale block
+ *  (2: 10x16 characters, 3: 15x24), built from font_5x7 on the fly
+ *
+ *  \param col Column to start drawing string
+ *  \param row Row to start drawing string
+ *  \param string The string
+ *  \param scale Block size of one font pixel, 1 or more (0 is taken
+ *  as 1)
+ *  \param fgColorBGR Foreground color in BGR
+ *  \param bgColorBGR Background color in BGR
+ */
+void drawString5x7Scaled(u_char col, u_char row, char *string, u_char scale,
+			 u_int fgColorBGR, u_int bgColorBGR);
+
+/** 5x7 font scaled, one window per character - this function draws
+ *  background pixels; a scale of 0 is taken as 1
+ */
+void drawChar5x7Scaled(u_char rcol, u_char rrow, char c, u_char scale,
+		       u_int fgColorBGR, u_int bgColorBGR);
+
+/** Draw string without background: only the lit pixels are written,
+ *  so the text can be laid over blocks or images
+ *
+ *  \param col Column to start drawing string
+ *  \param row Row to start drawing string
+ *  \param string The string
+ *  \param fgColorBGR Foreground color in BGR
+ */
+void drawString5x7Transparent(u_char col, u_char row, char *string,
+			      u_int fgColorBGR);
+
+/** 5x7 font without background: each vertical or horizontal run of lit
+ *  pixels is one fill (one window), so a glyph costs a handful of
+ *  windows instead of one per pixel
+ */
+void drawChar5x7Transparent(u_char rcol, u_char rrow, char c,
+			    u_int fgColorBGR);
+
+/** Draw image (row-major BGR pixels) in one window
+ *
+ *  \param colMin Column start
+ *  \param rowMin Row start
+ *  \param width Width of image
+ *  \param height Height of image
+ *  \param pixels width*height colors in BGR
+ */
+void drawImage(u_char colMin, u_char rowMin, u_char width, u_char height,
+	       const u_int *pixels);
+
 /** Draw rectangle outline
  *  
  *  \param colMin Column start
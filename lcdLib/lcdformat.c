@@ -0,0 +1,136 @@
+/** \file lcdformat.c
+ *  \brief Formatted 5x7 text without a string buffer
+ */
+#include <stdarg.h>
+#include "lcdutils.h"
+#include "lcddraw.h"
+#include "lcdformat.h"
+
+/** Where the next character goes (private) */
+typedef struct {
+  u_char col, row;
+  u_char transparent;
+  u_int fg, bg;
+} FormatPen;
+
+/** Draw one character and advance (private) */
+static void
+format_char(FormatPen *pen, char c)
+{
+  if (pen->transparent)
+    drawChar5x7Transparent(pen->col, pen->row, c, pen->fg);
+  else
+    drawChar5x7(pen->col, pen->row, c, pen->fg, pen->bg);
+  pen->col += 6;
+}
+
+/** Draw c n times (private) */
+static void
+format_pad(FormatPen *pen, char c, signed char n)
+{
+  for (; n > 0; n--)
+    format_char(pen, c);
+}
+
+/** Draw value in base 10 or 16, padded to width (private) */
+static void
+format_number(FormatPen *pen, u_int value, u_char base, u_char negative,
+	      u_char width, char pad)
+{
+  u_int power = 1;
+  u_char digits = 1;
+
+  while (value / power >= base) {	/**< largest power of base <= value */
+    power *= base;
+    digits++;
+  }
+  if (pad == ' ')
+    format_pad(pen, ' ', width - digits - negative);
+  if (negative)
+    format_char(pen, '-');
+  if (pad == '0')
+    format_pad(pen, '0', width - digits - negative);
+  for (; power; power /= base) {
+    u_char d = value / power;
+    value %= power;
+    format_char(pen, d < 10 ? '0' + d : 'a' + d - 10);
+  }
+}
+
+/** The formatter behind both entry points (private) */
+static u_char
+format_draw(FormatPen *pen, const char *format, va_list args)
+{
+  for (; *format; format++) {
+    char pad = ' ';
+    u_char width = 0;
+
+    if (*format != '%' || !format[1]) {
+      format_char(pen, *format);
+      continue;
+    }
+    format++;
+    if (*format == '0') {
+      pad = '0';
+      format++;
+    }
+    for (; *format >= '0' && *format <= '9'; format++)
+      width = width * 10 + *format - '0';
+
+    switch (*format) {
+    case 'd': {
+      int v = va_arg(args, int);
+      format_number(pen, v < 0 ? -(u_int)v : v, 10, v < 0, width, pad);
+      break;
+    }
+    case 'u':
+      format_number(pen, va_arg(args, u_int), 10, 0, width, pad);
+      break;
+    case 'x':
+      format_number(pen, va_arg(args, u_int), 16, 0, width, pad);
+      break;
+    case 's': {
+      const char *s = va_arg(args, const char *), *end = s;
+      while (*end)
+	end++;
+      format_pad(pen, ' ', width - (end - s));
+      while (*s)
+	format_char(pen, *s++);
+      break;
+    }
+    case 'c':
+      format_pad(pen, ' ', width - 1);
+      format_char(pen, va_arg(args, int));
+      break;
+    case 0:			/**< format ended inside a conversion */
+      return pen->col;
+    default:			/**< %% and unknown conversions: as is */
+      format_char(pen, *format);
+    }
+  }
+  return pen->col;
+}
+
+u_char
+drawFormat5x7(u_char col, u_char row, u_int fgColorBGR, u_int bgColorBGR,
+	      const char *format, ...)
+{
+  FormatPen pen = {col, row, 0, fgColorBGR, bgColorBGR};
+  va_list args;
+  va_start(args, format);
+  col = format_draw(&pen, format, args);
+  va_end(args);
+  return col;
+}
+
+u_char
+drawFormat5x7Transparent(u_char col, u_char row, u_int fgColorBGR,
+			 const char *format, ...)
+{
+  FormatPen pen = {col, row, 1, fgColorBGR, 0};
+  va_list args;
+  va_start(args, format);
+  col = format_draw(&pen, format, args);
+  va_end(args);
+  return col;
+}
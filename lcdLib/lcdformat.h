@@ -0,0 +1,44 @@
+/** \file lcdformat.h
+ *  \brief Formatted 5x7 text without a string buffer
+ *
+ *  A small printf that sends every character straight to the 5x7 glyph
+ *  renderer: no sprintf, no heap and no buffer for the text.  Numbers
+ *  are written most significant digit first by dividing by powers of
+ *  the base.
+ *
+ *  Conversions: %d (int), %u (u_int), %x (u_int, lowercase hex),
+ *  %s (string), %c (character) and %%.  A width after the % pads the
+ *  field on the left with spaces, or with zeros when it starts with 0
+ *  ("%5u", "%04x"); fixed-width fields fully overwrite the previous
+ *  value, so a HUD needs no clearing.
+ */
+
+#ifndef lcdformat_included
+#define lcdformat_included
+
+#include "lcdutils.h"
+
+/** Draw formatted text, with background (like drawString5x7)
+ *
+ *  \param col Column to start drawing
+ *  \param row Row to start drawing
+ *  \param fgColorBGR Foreground color in BGR
+ *  \param bgColorBGR Background color in BGR
+ *  \param format Text and conversions
+ *  \return Column after the last character
+ */
+u_char drawFormat5x7(u_char col, u_char row, u_int fgColorBGR, u_int bgColorBGR,
+		     const char *format, ...);
+
+/** Draw formatted text without background (like drawString5x7Transparent)
+ *
+ *  \param col Column to start drawing
+ *  \param row Row to start drawing
+ *  \param fgColorBGR Foreground color in BGR
+ *  \param format Text and conversions
+ *  \return Column after the last character
+ */
+u_char drawFormat5x7Transparent(u_char col, u_char row, u_int fgColorBGR,
+				const char *format, ...);
+
+#endif // included
@@ -0,0 +1,70 @@
+/** \file lcdinit.c
+ *  \brief LCD initialization timed by Timer A0
+ */
+#include <msp430.h>
+#include "lcdutils.h"
+#include "lcdinit.h"
+
+u_char _initStep(u_char restart);	/**< lcdutils.c */
+
+static volatile u_char initDone = 1;
+static u_int savedCtl, savedCcr0, savedCctl0; /**< Timer A0 before the init */
+
+/** Timer A0 counts SMCLK/8 (250kHz with configureClocks) */
+#define INIT_TICKS_PER_MS 250
+
+/** Time the delay returned by the table, or give the timer back once
+ *  the table is done (private) */
+static void
+lcd_initDelay(u_char ms)
+{
+  if (ms) {
+    TA0CCR0 = ms * INIT_TICKS_PER_MS - 1;
+    TA0CCTL0 = CCIE;
+    TA0CTL = TASSEL_2 + ID_3 + MC_1 + TACLR; /**< SMCLK/8, up mode */
+    return;
+  }
+  TA0CCR0 = savedCcr0;
+  TA0CCTL0 = savedCctl0;
+  TA0CTL = savedCtl | TACLR;
+  initDone = 1;
+}
+
+/** Init delay elapsed: continue with the table */
+void
+__interrupt_vec(TIMER0_A0_VECTOR) lcd_initTimer()
+{
+  TA0CTL = TASSEL_2 + ID_3 + MC_0; /**< stop timer */
+  lcd_initDelay(_initStep(0));
+  if (initDone)
+    __bic_SR_register_on_exit(CPUOFF); /**< wake lcd_init_wait */
+}
+
+void
+lcd_init_start()
+{
+  savedCtl = TA0CTL & ~TAIFG;
+  savedCcr0 = TA0CCR0;
+  savedCctl0 = TA0CCTL0 & ~CCIFG;
+  initDone = 0;
+  lcd_initDelay(_initStep(1));
+}
+
+u_char
+lcd_init_done()
+{
+  return initDone;
+}
+
+void
+lcd_init_wait()
+{
+  u_int sr = __get_SR_register();
+  __bic_SR_register(GIE);
+  while (!initDone) {
+    __bis_SR_register(CPUOFF + GIE); /**< sleep and enable in one write */
+    __bic_SR_register(GIE);
+  }
+  if (sr & GIE)
+    __bis_SR_register(GIE);
+}
@@ -0,0 +1,33 @@
+/** \file lcdinit.h
+ *  \brief LCD initialization timed by Timer A0, so the application can
+ *  do its own setup while the panel comes out of reset
+ *
+ *  lcdinit.o defines the TIMER0_A0 interrupt handler and is only linked
+ *  into applications that call lcd_init_start: an application with its
+ *  own TIMER0_A0 handler uses the blocking lcd_init() instead.  Timer A0
+ *  is borrowed while the sequence runs; its control, CCR0 and CCTL0
+ *  registers are put back when it is done (the count restarts from 0).
+ */
+
+#ifndef lcdinit_included
+#define lcdinit_included
+
+#include "lcdutils.h"
+
+/** Start initializing the onboard LCD without blocking
+ *
+ *  The reset/sleep-out delays are timed by Timer A0's CCR0 interrupt,
+ *  so other setup can run meanwhile; the delays only advance while
+ *  interrupts are enabled (lcd_init_wait enables them as it sleeps).
+ *  Do not draw before the sequence is done: poll lcd_init_done() or
+ *  call lcd_init_wait().
+ */
+void lcd_init_start();
+
+/** Nonzero once lcd_init_start's sequence has completed */
+u_char lcd_init_done();
+
+/** Sleep until lcd_init_start's sequence has completed */
+void lcd_init_wait();
+
+#endif // included
@@ -0,0 +1,176 @@
+/** \file lcdlist.c
+ *  \brief Display list: record a frame's draws, send them optimized
+ */
+#include "lcdutils.h"
+#include "lcddraw.h"
+#include "lcdlist.h"
+
+static DlOp *ops;
+static u_char opsSize, opsCount;
+
+/** True if the two ops share at least one pixel (dead ops have width 0) */
+static u_char
+dl_overlaps(const DlOp *a, const DlOp *b)
+{
+  return a->col < b->col + b->width && b->col < a->col + a->width &&
+    a->row < b->row + b->height && b->row < a->row + a->height;
+}
+
+/** True if a covers every pixel of b */
+static u_char
+dl_contains(const DlOp *a, const DlOp *b)
+{
+  return a->col <= b->col && b->col + b->width <= a->col + a->width &&
+    a->row <= b->row && b->row + b->height <= a->row + a->height;
+}
+
+/** If the union of fills a and b is a rectangle, store it in b */
+static u_char
+dl_union(const DlOp *a, DlOp *b)
+{
+  u_char lo, hi;
+  if (a->row == b->row && a->height == b->height &&
+      a->col <= b->col + b->width && b->col <= a->col + a->width) {
+    lo = a->col < b->col ? a->col : b->col;
+    hi = a->col + a->width > b->col + b->width ? a->col + a->width : b->col + b->width;
+    b->col = lo;
+    b->width = hi - lo;
+    return 1;
+  }
+  if (a->col == b->col && a->width == b->width &&
+      a->row <= b->row + b->height && b->row <= a->row + a->height) {
+    lo = a->row < b->row ? a->row : b->row;
+    hi = a->row + a->height > b->row + b->height ? a->row + a->height : b->row + b->height;
+    b->row = lo;
+    b->height = hi - lo;
+    return 1;
+  }
+  if (dl_contains(a, b)) {
+    b->col = a->col; b->row = a->row;
+    b->width = a->width; b->height = a->height;
+    return 1;
+  }
+  return 0;
+}
+
+/** Remove an op from the list */
+static void
+dl_kill(DlOp *op)
+{
+  op->kind = DL_DEAD;
+  op->width = 0;
+}
+
+/** Sort key: column range first, then row */
+static u_char
+dl_before(const DlOp *a, const DlOp *b)
+{
+  if (a->col != b->col) return a->col < b->col;
+  if (a->width != b->width) return a->width < b->width;
+  return a->row < b->row;
+}
+
+/** Merge, drop covered ops and sort (private) */
+static void
+dl_optimize()
+{
+  u_char i, j, k;
+
+  /* A same-color fill i can be drawn later, as part of fill j, when
+     nothing between them touches i. */
+  for (j = 1; j < opsCount; j++) {
+    if (ops[j].kind != DL_FILL)
+      continue;
+    for (i = j; i-- > 0; ) {
+      DlOp merged = ops[j];
+      if (ops[i].kind != DL_FILL || ops[i].color != merged.color ||
+	  !dl_union(&ops[i], &merged))
+	continue;
+      for (k = i + 1; k < j && !dl_overlaps(&ops[k], &ops[i]); k++)
+	;
+      if (k == j) {
+	ops[j] = merged;
+	dl_kill(&ops[i]);
+      }
+    }
+  }
+
+  /* Every op is opaque: one covered by a later op is never seen. */
+  for (i = 0; i < opsCount; i++) {
+    if (ops[i].kind == DL_DEAD)
+      continue;
+    for (j = i + 1; j < opsCount; j++) {
+      if (ops[j].kind != DL_DEAD && dl_contains(&ops[j], &ops[i])) {
+	dl_kill(&ops[i]);
+	break;
+      }
+    }
+  }
+
+  /* Insertion sort that only swaps neighbours that do not overlap, so
+     the painter's order of overlapping ops is kept. */
+  for (i = 1; i < opsCount; i++) {
+    for (j = i; j > 0 && ops[j].kind != DL_DEAD &&
+	   (ops[j - 1].kind == DL_DEAD ||
+	    (dl_before(&ops[j], &ops[j - 1]) && !dl_overlaps(&ops[j], &ops[j - 1])));
+	 j--) {
+      DlOp t = ops[j];
+      ops[j] = ops[j - 1];
+      ops[j - 1] = t;
+    }
+  }
+}
+
+/** Record one op, flushing first if the buffer is full (private) */
+static void
+dl_record(const DlOp *op)
+{
+  if (!op->width || !op->height)
+    return;
+  if (opsCount == opsSize)
+    dlFlush();
+  ops[opsCount++] = *op;
+}
+
+void
+dlBegin(DlOp *buf, u_char size)
+{
+  ops = buf;
+  opsSize = size;
+  opsCount = 0;
+  lcd_dlRecord = dl_record;
+}
+
+void
+dlFlush()
+{
+  u_char i;
+  lcd_dlRecord = 0;		/**< the draws below go to the LCD */
+  dl_optimize();
+  for (i = 0; i < opsCount; i++) {
+    const DlOp *op = &ops[i];
+    switch (op->kind) {
+    case DL_FILL:
+      fillRectangle(op->col, op->row, op->width, op->height, op->color);
+      break;
+    case DL_CHAR:
+      if (op->width == 5)
+	drawChar5x7(op->col, op->row, op->c, op->color, op->u.bg);
+      else
+	drawChar5x7Scaled(op->col, op->row, op->c, op->width / 5, op->color, op->u.bg);
+      break;
+    case DL_IMAGE:
+      drawImage(op->col, op->row, op->width, op->height, op->u.pixels);
+      break;
+    }
+  }
+  opsCount = 0;
+  lcd_dlRecord = dl_record;
+}
+
+void
+dlEnd()
+{
+  dlFlush();
+  lcd_dlRecord = 0;
+}
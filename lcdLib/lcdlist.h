@@ -0,0 +1,64 @@
+/** \file lcdlist.h
+ *  \brief Display list: record a frame's draws, send them optimized
+ *
+ *  Between dlBegin and dlEnd, fillRectangle, drawPixel, drawRectOutline,
+ *  drawChar5x7/drawString5x7 (also Scaled) and drawImage are recorded instead of being
+ *  sent to the LCD.  On flush the list is optimized and then drawn:
+ *   - same-color fills that touch or overlap with a rectangular union
+ *     are merged into one fill
+ *   - ops completely covered by a later op are dropped
+ *   - the remaining ops are reordered (only past ops they do not
+ *     overlap) so that ops sharing a column range are sent together,
+ *     which lets lcd_setArea skip the column command
+ *  The screen ends up exactly as if the ops had been drawn in order.
+ *
+ *  Recording is global: anything drawn between dlBegin and dlEnd is
+ *  recorded, including draws from interrupt handlers, and the list is
+ *  not safe against them.  If handlers draw, keep interrupts off from
+ *  dlBegin to dlEnd.
+ */
+
+#ifndef lcdlist_included
+#define lcdlist_included
+
+#include "lcdutils.h"
+
+/** Op kinds */
+#define DL_DEAD  0		/**< removed by the optimizer */
+#define DL_FILL  1		/**< fillRectangle */
+#define DL_CHAR  2		/**< drawChar5x7, or Scaled when width > 5 */
+#define DL_IMAGE 3		/**< drawImage */
+
+/** One recorded op (10 bytes) */
+typedef struct {
+  u_char col, row, width, height;
+  u_char kind;
+  char c;			/**< DL_CHAR: character */
+  u_int color;			/**< fill color, or DL_CHAR foreground */
+  union {
+    u_int bg;			/**< DL_CHAR: background */
+    const u_int *pixels;	/**< DL_IMAGE: row-major BGR pixels */
+  } u;
+} DlOp;
+
+/** Start recording into the caller's buffer
+ *
+ *  The buffer only has to live until dlEnd, so it can be a local array
+ *  of the function that draws the frame.  When it fills up, the ops
+ *  recorded so far are flushed and recording continues.
+ *
+ *  \param buf Op buffer
+ *  \param size Number of ops in buf
+ */
+void dlBegin(DlOp *buf, u_char size);
+
+/** Optimize and draw the ops recorded so far; keep recording */
+void dlFlush();
+
+/** Flush and stop recording: draws go straight to the LCD again */
+void dlEnd();
+
+/** Recording hook used by lcddraw.c (private); 0 when not recording */
+extern void (*lcd_dlRecord)(const DlOp *op);
+
+#endif // included
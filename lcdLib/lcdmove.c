@@ -0,0 +1,84 @@
+/** \file lcdmove.c
+ *  \brief Move a drawn object by sending only its changed edges
+ */
+#include "lcdutils.h"
+#include "lcddraw.h"
+#include "lcdmove.h"
+
+void
+moveRectangle(u_char col, u_char row, u_char width, u_char height,
+	      signed char dx, signed char dy,
+	      u_int fgColorBGR, u_int bgColorBGR)
+{
+  u_char newCol = col + dx, newRow = row + dy;
+  u_char adx = dx < 0 ? -dx : dx, ady = dy < 0 ? -dy : dy;
+  u_char overlapCol, overlapWidth;
+
+  if (adx >= width || ady >= height) { /**< no overlap: erase and draw */
+    fillRectangle(col, row, width, height, bgColorBGR);
+    fillRectangle(newCol, newRow, width, height, fgColorBGR);
+    return;
+  }
+  /**< columns only the old (or new) position covers: full height */
+  if (dx > 0) {
+    fillRectangle(col, row, adx, height, bgColorBGR);
+    fillRectangle(col + width, newRow, adx, height, fgColorBGR);
+  } else if (dx < 0) {
+    fillRectangle(newCol + width, row, adx, height, bgColorBGR);
+    fillRectangle(newCol, newRow, adx, height, fgColorBGR);
+  }
+  /**< rows only one position covers, over the shared columns */
+  overlapCol = dx > 0 ? newCol : col;
+  overlapWidth = width - adx;
+  if (dy > 0) {
+    fillRectangle(overlapCol, row, overlapWidth, ady, bgColorBGR);
+    fillRectangle(overlapCol, row + height, overlapWidth, ady, fgColorBGR);
+  } else if (dy < 0) {
+    fillRectangle(overlapCol, newRow + height, overlapWidth, ady, bgColorBGR);
+    fillRectangle(overlapCol, newRow, overlapWidth, ady, fgColorBGR);
+  }
+}
+
+/** Send each run of set bits of a row as one fill (private) */
+static void
+move_runs(u_char col, u_char row, unsigned long bits, u_int colorBGR)
+{
+  u_char x = 0, first;
+  while (bits) {
+    while (!(bits & 1)) {
+      bits >>= 1;
+      x++;
+    }
+    first = x;
+    while (bits & 1) {
+      bits >>= 1;
+      x++;
+    }
+    fillRectangle(col + first, row, x - first, 1, colorBGR);
+  }
+}
+
+void
+moveMask(u_char col, u_char row, u_char width, u_char height,
+	 const u_int *mask, signed char dx, signed char dy,
+	 u_int fgColorBGR, u_int bgColorBGR)
+{
+  /**< union of both positions: rows top..top+rows-1, columns from left */
+  u_char left = dx < 0 ? col + dx : col;
+  u_char oldShift = col - left, newShift = col + dx - left;
+  int top = dy < 0 ? row + dy : row;
+  u_char rows = height + (dy < 0 ? -dy : dy);
+  u_int keep = width >= 16 ? 0xffff : (1u << width) - 1;
+  u_char y;
+
+  for (y = 0; y < rows; y++) {
+    int oldY = top + y - row, newY = oldY - dy;
+    unsigned long oldBits = 0, newBits = 0;
+    if (oldY >= 0 && oldY < height)
+      oldBits = (unsigned long)(mask[oldY] & keep) << oldShift;
+    if (newY >= 0 && newY < height)
+      newBits = (unsigned long)(mask[newY] & keep) << newShift;
+    move_runs(left, top + y, oldBits & ~newBits, bgColorBGR);
+    move_runs(left, top + y, newBits & ~oldBits, fgColorBGR);
+  }
+}
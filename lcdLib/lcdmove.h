@@ -0,0 +1,49 @@
+/** \file lcdmove.h
+ *  \brief Move a drawn object by sending only its changed edges
+ *
+ *  When a solid object moves by (dx, dy), the pixels it still covers
+ *  are already right.  These calls paint only the trailing edge (with
+ *  the background) and the leading edge (with the object's color), so
+ *  a move costs SPI traffic in proportion to the perimeter, not the
+ *  area.  The object must be on screen at its old position.
+ */
+
+#ifndef lcdmove_included
+#define lcdmove_included
+
+#include "lcdutils.h"
+
+/** Move a solid rectangle
+ *
+ *  \param col Old column start
+ *  \param row Old row start
+ *  \param width Width of rectangle
+ *  \param height Height of rectangle
+ *  \param dx Columns moved (new col = col + dx)
+ *  \param dy Rows moved (new row = row + dy)
+ *  \param fgColorBGR Color of the rectangle
+ *  \param bgColorBGR Color left behind
+ */
+void moveRectangle(u_char col, u_char row, u_char width, u_char height,
+		   signed char dx, signed char dy,
+		   u_int fgColorBGR, u_int bgColorBGR);
+
+/** Move a masked shape (at most 16 pixels wide, and width + |dx| <= 32)
+ *
+ *  Each row sends one window per run of pixels that changed.
+ *
+ *  \param col Old column of the mask's left edge
+ *  \param row Old row of the mask's top edge
+ *  \param width Mask width
+ *  \param height Mask height
+ *  \param mask One word per row, bit k set if column col+k is drawn
+ *  \param dx Columns moved
+ *  \param dy Rows moved
+ *  \param fgColorBGR Color of the shape
+ *  \param bgColorBGR Color left behind
+ */
+void moveMask(u_char col, u_char row, u_char width, u_char height,
+	      const u_int *mask, signed char dx, signed char dy,
+	      u_int fgColorBGR, u_int bgColorBGR);
+
+#endif // included
@@ -0,0 +1,88 @@
+/** \file lcdshadow.c
+ *  \brief Shadow of a cell grid: skip writes to cells that already
+ *  show the right color
+ */
+#include "lcdutils.h"
+#include "lcddraw.h"
+#include "lcdshadow.h"
+
+#define SHADOW_DIRTY 8		/**< nibble bit: not on screen yet */
+
+/** Nibble of a cell (private) */
+static u_char
+shadow_get(const ShadowGrid *grid, u_char col, u_char row)
+{
+  u_int i = row * grid->cols + col;
+  return (grid->cells[i >> 1] >> ((i & 1) << 2)) & 0x0f;
+}
+
+/** Store the nibble of a cell (private) */
+static void
+shadow_put(const ShadowGrid *grid, u_char col, u_char row, u_char nibble)
+{
+  u_int i = row * grid->cols + col;
+  u_char shift = (i & 1) << 2;
+  u_char *p = &grid->cells[i >> 1];
+  *p = (*p & ~(0x0f << shift)) | (nibble << shift);
+}
+
+void
+shadowInvalidate(const ShadowGrid *grid, u_char col0, u_char row0,
+		 u_char col1, u_char row1)
+{
+  u_char col, row;
+  for (row = row0; row <= row1; row++)
+    for (col = col0; col <= col1; col++)
+      shadow_put(grid, col, row, SHADOW_UNKNOWN);
+}
+
+u_char
+shadowSet(const ShadowGrid *grid, u_char col, u_char row, u_char index)
+{
+  if ((shadow_get(grid, col, row) & ~SHADOW_DIRTY) == index)
+    return 0;			/**< already there, or already marked */
+  shadow_put(grid, col, row, index | SHADOW_DIRTY);
+  return 1;
+}
+
+void
+shadowSetRow(const ShadowGrid *grid, u_char row, const u_char *indexes)
+{
+  u_char col;
+  for (col = 0; col < grid->cols; col++)
+    shadowSet(grid, col, row, indexes[col]);
+}
+
+u_char
+shadowNextDirty(const ShadowGrid *grid, ShadowRun *run)
+{
+  u_char col = run->col + run->width, row = run->row, nibble;
+
+  for (; row < grid->rows; row++, col = 0) {
+    for (; col < grid->cols; col++) {
+      nibble = shadow_get(grid, col, row);
+      if (!(nibble & SHADOW_DIRTY))
+	continue;
+      run->col = col;
+      run->row = row;
+      run->index = nibble & ~SHADOW_DIRTY;
+      do {			/**< extend over marked cells of the same index */
+	shadow_put(grid, col++, row, run->index);
+      } while (col < grid->cols && shadow_get(grid, col, row) == nibble);
+      run->width = col - run->col;
+      return 1;
+    }
+  }
+  return 0;
+}
+
+void
+shadowFlush(const ShadowGrid *grid)
+{
+  ShadowRun run = {0, 0, 0, 0};
+  while (shadowNextDirty(grid, &run))
+    fillRectangle(grid->col + run.col * grid->cellWidth,
+		  grid->row + run.row * grid->cellHeight,
+		  run.width * grid->cellWidth, grid->cellHeight,
+		  grid->palette[run.index]);
+}
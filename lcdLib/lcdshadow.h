@@ -0,0 +1,87 @@
+/** \file lcdshadow.h
+ *  \brief Shadow of a cell grid: skip writes to cells that already
+ *  show the right color
+ *
+ *  The application keeps one nibble per cell in its own buffer: a
+ *  palette index (0..6) and a bit that says the screen does not show it
+ *  yet.  shadowSet only marks a cell when its index changes, and
+ *  shadowNextDirty hands back the marked cells as horizontal runs of
+ *  one index, so shadowFlush sends one fill per run.  Setting a whole
+ *  area to what it already shows costs nothing on the SPI bus.
+ *
+ *  Anything else drawn over the grid (a sprite, text) makes the shadow
+ *  wrong for those cells: call shadowInvalidate for them, and the next
+ *  shadowSet repaints them whatever their index.
+ */
+
+#ifndef lcdshadow_included
+#define lcdshadow_included
+
+#include "lcdutils.h"
+
+#define SHADOW_UNKNOWN 7	/**< screen content not known */
+
+/** Buffer size for a cols x rows grid (4 bits per cell) */
+#define SHADOW_BYTES(cols, rows) (((cols) * (rows) + 1) / 2)
+
+/** A grid and its shadow */
+typedef struct {
+  u_char col, row;		/**< screen position of cell (0,0) */
+  u_char cellWidth, cellHeight;	/**< cell size in pixels */
+  u_char cols, rows;		/**< grid size */
+  const u_int *palette;		/**< BGR color of each index */
+  u_char *cells;		/**< SHADOW_BYTES(cols, rows) bytes */
+} ShadowGrid;
+
+/** Cells col..col+width-1 of row, all to be painted index; cell units */
+typedef struct {
+  u_char col, row, width, index;
+} ShadowRun;
+
+/** Forget what cells col0..col1 x row0..row1 show (also the start-up
+ *  state: call it on the whole grid first)
+ *
+ *  \param grid The grid
+ *  \param col0 First column
+ *  \param row0 First row
+ *  \param col1 Last column
+ *  \param row1 Last row
+ */
+void shadowInvalidate(const ShadowGrid *grid, u_char col0, u_char row0,
+		      u_char col1, u_char row1);
+
+/** Ask for cell col,row to show index
+ *
+ *  \param grid The grid
+ *  \param col Column
+ *  \param row Row
+ *  \param index Palette index, 0..6
+ *  \return 1 if the cell has to be repainted
+ */
+u_char shadowSet(const ShadowGrid *grid, u_char col, u_char row, u_char index);
+
+/** shadowSet for every cell of a row
+ *
+ *  \param grid The grid
+ *  \param row Row
+ *  \param indexes One palette index per column
+ */
+void shadowSetRow(const ShadowGrid *grid, u_char row, const u_char *indexes);
+
+/** Next run of cells to repaint, scanning on from the previous run
+ *
+ *  Start with a zeroed run.  The run's cells are taken as painted.
+ *
+ *  \param grid The grid
+ *  \param run In: the previous run; out: the next one
+ *  \return 0 when no cells are left
+ */
+u_char shadowNextDirty(const ShadowGrid *grid, ShadowRun *run);
+
+/** Paint every marked cell, one fillRectangle per run
+ *
+ *  \param grid The grid
+ */
+void shadowFlush(const ShadowGrid *grid);
+
+#endif // included
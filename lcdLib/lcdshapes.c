@@ -0,0 +1,218 @@
+/** \file lcdshapes.c
+ *  \brief Lines, circles, ellipses and polygons drawn as spans
+ */
+#include "lcdutils.h"
+#include "lcddraw.h"
+#include "lcdshapes.h"
+
+/** Horizontal run from col a to col b (either order) (private) */
+static void
+shape_hrun(int a, int b, int row, u_int colorBGR)
+{
+  if (a > b) { int t = a; a = b; b = t; }
+  fillRectangle(a, row, b - a + 1, 1, colorBGR);
+}
+
+/** Vertical run from row a to row b (either order) (private) */
+static void
+shape_vrun(int col, int a, int b, u_int colorBGR)
+{
+  if (a > b) { int t = a; a = b; b = t; }
+  fillRectangle(col, a, 1, b - a + 1, colorBGR);
+}
+
+void
+drawLine(u_char col0, u_char row0, u_char col1, u_char row1, u_int colorBGR)
+{
+  int dx = col1 - col0, dy = row1 - row0;
+  int adx = dx < 0 ? -dx : dx, ady = dy < 0 ? -dy : dy;
+  int sx = dx < 0 ? -1 : 1, sy = dy < 0 ? -1 : 1;
+  int x = col0, y = row0, start, err, i;
+
+  if (adx >= ady) {		/**< runs along rows */
+    err = 2 * ady - adx;
+    for (start = x, i = 0; i < adx; i++) {
+      if (err > 0) {		/**< next pixel is on the next row */
+	shape_hrun(start, x, y, colorBGR);
+	y += sy;
+	err -= 2 * adx;
+	start = x + sx;
+      }
+      err += 2 * ady;
+      x += sx;
+    }
+    shape_hrun(start, x, y, colorBGR);
+  } else {			/**< runs along columns */
+    err = 2 * adx - ady;
+    for (start = y, i = 0; i < ady; i++) {
+      if (err > 0) {
+	shape_vrun(x, start, y, colorBGR);
+	x += sx;
+	err -= 2 * ady;
+	start = y + sy;
+      }
+      err += 2 * adx;
+      y += sy;
+    }
+    shape_vrun(x, start, y, colorBGR);
+  }
+}
+
+/** The 8 images of the first-octant run x0..x1 at height y (private) */
+static void
+circle_runs(int col, int row, int x0, int x1, int y, u_int colorBGR)
+{
+  shape_hrun(col + x0, col + x1, row - y, colorBGR);
+  shape_hrun(col - x0, col - x1, row - y, colorBGR);
+  shape_hrun(col + x0, col + x1, row + y, colorBGR);
+  shape_hrun(col - x0, col - x1, row + y, colorBGR);
+  shape_vrun(col - y, row + x0, row + x1, colorBGR);
+  shape_vrun(col - y, row - x0, row - x1, colorBGR);
+  shape_vrun(col + y, row + x0, row + x1, colorBGR);
+  shape_vrun(col + y, row - x0, row - x1, colorBGR);
+}
+
+void
+drawCircle(u_char col, u_char row, u_char radius, u_int colorBGR)
+{
+  int x = 0, y = radius, d = 1 - radius, start = 0;
+
+  while (x <= y) {
+    if (d < 0) {
+      d += 2 * x + 3;
+    } else {			/**< y steps: the run at this height ends */
+      circle_runs(col, row, start, x, y, colorBGR);
+      d += 2 * (x - y) + 5;
+      y--;
+      start = x + 1;
+    }
+    x++;
+  }
+  if (start < x)
+    circle_runs(col, row, start, x - 1, y, colorBGR);
+}
+
+void
+fillCircle(u_char col, u_char row, u_char radius, u_int colorBGR)
+{
+  fillEllipse(col, row, radius, radius, colorBGR);
+}
+
+void
+fillEllipse(u_char col, u_char row, u_char radiusCol, u_char radiusRow,
+	    u_int colorBGR)
+{
+  /* Row dy spans -x..x for the largest x with
+     x^2 ry^2 + dy^2 rx^2 <= rx^2 ry^2; x only shrinks as dy grows. */
+  long rx2 = (long)radiusCol * radiusCol, ry2 = (long)radiusRow * radiusRow;
+  int x = radiusCol, dy;
+
+  fillRectangle(col - x, row, 2 * x + 1, 1, colorBGR);
+  for (dy = 1; dy <= radiusRow; dy++) {
+    long limit = rx2 * (ry2 - (long)dy * dy);
+    while (x > 0 && (long)x * x * ry2 > limit)
+      x--;
+    fillRectangle(col - x, row - dy, 2 * x + 1, 1, colorBGR);
+    fillRectangle(col - x, row + dy, 2 * x + 1, 1, colorBGR);
+  }
+}
+
+/** One side of a convex polygon, walked from its top corner down */
+typedef struct {
+  u_char v;			/**< corner the current edge ends at */
+  signed char dir;		/**< +1 or -1 around the polygon */
+  long x, dx;			/**< 16.16 column at the current row, per-row step */
+} PolyChain;
+
+#define PCOL(i) points[2 * (i)]
+#define PROW(i) points[2 * (i) + 1]
+
+/** Move the chain to its next edge that is not flat, positioned at row
+ *  (private) */
+static void
+poly_next(const u_char *points, u_char n, PolyChain *c, int row)
+{
+  u_char from, k;
+  for (k = n; k; k--) {
+    from = c->v;
+    c->v = (from + n + c->dir) % n;
+    if (PROW(c->v) > PROW(from)) {
+      c->dx = ((long)(PCOL(c->v) - PCOL(from)) << 16) / (PROW(c->v) - PROW(from));
+      c->x = ((long)PCOL(from) << 16) + (row - PROW(from)) * c->dx;
+      return;
+    }
+  }
+}
+
+/** Widen lo..hi by the flat edges that follow the chain's corner when
+ *  that corner is on row (private) */
+static void
+poly_flat(const u_char *points, u_char n, const PolyChain *c, int row,
+	  int *lo, int *hi)
+{
+  u_char v = c->v, k;
+  for (k = n; k && PROW(v) == row; k--) {
+    if (PCOL(v) < *lo) *lo = PCOL(v);
+    if (PCOL(v) > *hi) *hi = PCOL(v);
+    v = (v + n + c->dir) % n;
+  }
+}
+
+void
+fillConvexPolygonRows(const u_char *points, u_char n,
+		      u_char firstRow, u_char lastRow, u_int colorBGR)
+{
+  PolyChain a, b;
+  u_char i, top = 0, bottomRow = PROW(0);
+  int row;
+
+  for (i = 1; i < n; i++) {
+    if (PROW(i) < PROW(top)) top = i;
+    if (PROW(i) > bottomRow) bottomRow = PROW(i);
+  }
+  if (bottomRow == PROW(top)) {	/**< flat: a single span */
+    u_char lo = PCOL(0), hi = PCOL(0);
+    for (i = 1; i < n; i++) {
+      if (PCOL(i) < lo) lo = PCOL(i);
+      if (PCOL(i) > hi) hi = PCOL(i);
+    }
+    if (bottomRow >= firstRow && bottomRow <= lastRow)
+      shape_hrun(lo, hi, bottomRow, colorBGR);
+    return;
+  }
+
+  /* walk both sides down from the top corner, one row at a time */
+  row = PROW(top);
+  a.v = b.v = top;
+  a.dir = 1;
+  b.dir = -1;
+  poly_next(points, n, &a, row);
+  poly_next(points, n, &b, row);
+  for (; row <= bottomRow && row <= lastRow; row++) {
+    if (PROW(a.v) < row) poly_next(points, n, &a, row);
+    if (PROW(b.v) < row) poly_next(points, n, &b, row);
+    if (row >= firstRow) {
+      int lo = (a.x + 0x8000) >> 16, hi = (b.x + 0x8000) >> 16;
+      if (lo > hi) { int t = lo; lo = hi; hi = t; }
+      poly_flat(points, n, &a, row, &lo, &hi);	/**< corners rounded flat */
+      poly_flat(points, n, &b, row, &lo, &hi);
+      shape_hrun(lo, hi, row, colorBGR);
+    }
+    a.x += a.dx;
+    b.x += b.dx;
+  }
+}
+
+void
+fillConvexPolygon(const u_char *points, u_char n, u_int colorBGR)
+{
+  fillConvexPolygonRows(points, n, 0, 255, colorBGR);
+}
+
+void
+fillTriangle(u_char col0, u_char row0, u_char col1, u_char row1,
+	     u_char col2, u_char row2, u_int colorBGR)
+{
+  u_char points[6] = {col0, row0, col1, row1, col2, row2};
+  fillConvexPolygon(points, 3, colorBGR);
+}
@@ -0,0 +1,92 @@
+/** \file lcdshapes.h
+ *  \brief Lines, circles, ellipses and polygons drawn as spans
+ *
+ *  Every shape is sent as horizontal or vertical runs, one lcd_setArea
+ *  window per run, instead of one window per pixel.
+ */
+
+#ifndef lcdshapes_included
+#define lcdshapes_included
+
+#include "lcdutils.h"
+
+/** Draw line (Bresenham) from col0,row0 to col1,row1, ends included
+ *
+ *  Horizontal and vertical lines are a single window; other lines send
+ *  one window per run of pixels along their major axis.
+ *
+ *  \param col0 Start column
+ *  \param row0 Start row
+ *  \param col1 End column
+ *  \param row1 End row
+ *  \param colorBGR Color of line in BGR
+ */
+void drawLine(u_char col0, u_char row0, u_char col1, u_char row1,
+	      u_int colorBGR);
+
+/** Draw circle outline (midpoint)
+ *
+ *  \param col Center column
+ *  \param row Center row
+ *  \param radius Radius
+ *  \param colorBGR Color of circle in BGR
+ */
+void drawCircle(u_char col, u_char row, u_char radius, u_int colorBGR);
+
+/** Fill circle, one window per scanline
+ *
+ *  \param col Center column
+ *  \param row Center row
+ *  \param radius Radius
+ *  \param colorBGR Color of circle in BGR
+ */
+void fillCircle(u_char col, u_char row, u_char radius, u_int colorBGR);
+
+/** Fill axis-aligned ellipse, one window per scanline
+ *
+ *  \param col Center column
+ *  \param row Center row
+ *  \param radiusCol Horizontal radius
+ *  \param radiusRow Vertical radius
+ *  \param colorBGR Color of ellipse in BGR
+ */
+void fillEllipse(u_char col, u_char row, u_char radiusCol, u_char radiusRow,
+		 u_int colorBGR);
+
+/** Fill triangle, one window per scanline
+ *
+ *  \param col0 Column of the first corner
+ *  \param row0 Row of the first corner
+ *  \param col1 Column of the second corner
+ *  \param row1 Row of the second corner
+ *  \param col2 Column of the third corner
+ *  \param row2 Row of the third corner
+ *  \param colorBGR Color of triangle in BGR
+ */
+void fillTriangle(u_char col0, u_char row0, u_char col1, u_char row1,
+		  u_char col2, u_char row2, u_int colorBGR);
+
+/** Fill convex polygon, one window per scanline
+ *
+ *  \param points n (col, row) pairs, in order around the polygon
+ *  \param n Number of corners
+ *  \param colorBGR Color of polygon in BGR
+ */
+void fillConvexPolygon(const u_char *points, u_char n, u_int colorBGR);
+
+/** Fill only scanlines firstRow..lastRow of a convex polygon
+ *
+ *  Draws a growing shape by sending just its new rows, or erases a
+ *  shape by sending its own spans in the background color instead of
+ *  clearing the screen.
+ *
+ *  \param points n (col, row) pairs, in order around the polygon
+ *  \param n Number of corners
+ *  \param firstRow First screen row to fill
+ *  \param lastRow Last screen row to fill
+ *  \param colorBGR Color in BGR
+ */
+void fillConvexPolygonRows(const u_char *points, u_char n,
+			   u_char firstRow, u_char lastRow, u_int colorBGR);
+
+#endif // included
@@ -0,0 +1,149 @@
+/** \file lcdsprite.c
+ *  \brief Cell sprites over a grid, with background restore
+ */
+#include "lcdutils.h"
+#include "lcddraw.h"
+#include "lcdsprite.h"
+#include "lcdcanvas.h"
+
+#define SPRITE_CANVAS 16	/**< largest cell composed off-screen */
+
+/** Cell n of the update: the drawn cells, then the new cells, of each
+ *  sprite in turn (private) */
+static void
+sprite_cell(const SpriteLayer *l, u_char n, signed char *col, signed char *row)
+{
+  const Sprite *s = l->sprites;
+  for (;; s++) {
+    if (n < s->drawnCount) {
+      *col = s->drawnCol[n];
+      *row = s->drawnRow[n];
+      return;
+    }
+    n -= s->drawnCount;
+    if (n < s->count) {
+      *col = s->col + s->dx[n];
+      *row = s->row + s->dy[n];
+      return;
+    }
+    n -= s->count;
+  }
+}
+
+/** Topmost sprite over col,row, on screen (drawn) or after the update;
+ *  -1 for the background (private) */
+static signed char
+sprite_top(const SpriteLayer *l, signed char col, signed char row, u_char drawn)
+{
+  signed char k;
+  u_char i;
+  for (k = l->numSprites - 1; k >= 0; k--) {
+    const Sprite *s = &l->sprites[k];
+    if (drawn) {
+      for (i = 0; i < s->drawnCount; i++)
+	if (s->drawnCol[i] == col && s->drawnRow[i] == row)
+	  return k;
+    } else {
+      for (i = 0; i < s->count; i++)
+	if (s->col + s->dx[i] == col && s->row + s->dy[i] == row)
+	  return k;
+    }
+  }
+  return -1;
+}
+
+/** Paint one cell with sprite k (or the background if k < 0); was is
+ *  what the cell showed before (private) */
+static void
+sprite_paint(const SpriteLayer *l, signed char col, signed char row,
+	     signed char k, signed char was)
+{
+  u_char x = l->col + col * l->cellWidth, y = l->row + row * l->cellHeight;
+  const Sprite *s;
+
+  if (k < 0) {			/**< no sprite left: the background */
+    fillRectangle(x, y, l->cellWidth, l->cellHeight,
+		  l->background(l->ctx, col, row));
+    return;
+  }
+  s = &l->sprites[k];
+  if (s->style == SPRITE_SOLID) {
+    fillRectangle(x, y, l->cellWidth, l->cellHeight, s->color);
+    return;
+  }
+  if (was >= 0 &&
+      l->cellWidth <= SPRITE_CANVAS && l->cellHeight <= SPRITE_CANVAS) {
+    /* an outline replacing another sprite: fill and outline composed
+       off-screen, so each pixel is sent once */
+    u_int palette[2];
+    u_char pixels[CANVAS_BYTES(SPRITE_CANVAS, SPRITE_CANVAS, 1)];
+    Canvas cv = {x, y, l->cellWidth, l->cellHeight, 1, 0, palette, pixels};
+    canvasBegin(&cv, l->background(l->ctx, col, row));
+    drawRectOutline(x, y, l->cellWidth - 1, l->cellHeight - 1, s->color);
+    canvasEnd(&cv);
+    return;
+  }
+  if (was >= 0)			/**< an outline over the background needs no fill */
+    fillRectangle(x, y, l->cellWidth, l->cellHeight,
+		  l->background(l->ctx, col, row));
+  drawRectOutline(x, y, l->cellWidth - 1, l->cellHeight - 1, s->color);
+}
+
+void
+spriteUpdate(const SpriteLayer *l)
+{
+  u_char total = 0, n, m, k, i;
+  signed char col, row, c2, r2, now, was;
+
+  for (k = 0; k < l->numSprites; k++)
+    total += l->sprites[k].drawnCount + l->sprites[k].count;
+
+  for (n = 0; n < total; n++) {
+    sprite_cell(l, n, &col, &row);
+    if (col < 0 || col >= l->cols || row < 0 || row >= l->rows)
+      continue;
+    for (m = 0; m < n; m++) {	/**< each cell once */
+      sprite_cell(l, m, &c2, &r2);
+      if (c2 == col && r2 == row)
+	break;
+    }
+    if (m < n)
+      continue;
+    was = sprite_top(l, col, row, 1);
+    now = sprite_top(l, col, row, 0);
+    if (now == was && (now < 0 ||
+		       (l->sprites[now].color == l->sprites[now].drawnColor &&
+			l->sprites[now].style == l->sprites[now].drawnStyle)))
+      continue;			/**< unchanged */
+    sprite_paint(l, col, row, now, was);
+  }
+
+  for (k = 0; k < l->numSprites; k++) {
+    Sprite *s = &l->sprites[k];
+    for (i = 0; i < s->count; i++) {
+      s->drawnCol[i] = s->col + s->dx[i];
+      s->drawnRow[i] = s->row + s->dy[i];
+    }
+    s->drawnCount = s->count;
+    s->drawnColor = s->color;
+    s->drawnStyle = s->style;
+  }
+}
+
+void
+spriteForgetArea(const SpriteLayer *l, u_char col0, u_char row0,
+		 u_char col1, u_char row1)
+{
+  u_char k, i, n;
+  for (k = 0; k < l->numSprites; k++) {
+    Sprite *s = &l->sprites[k];
+    for (i = n = 0; i < s->drawnCount; i++) {
+      signed char col = s->drawnCol[i], row = s->drawnRow[i];
+      if (col >= col0 && col <= col1 && row >= row0 && row <= row1)
+	continue;		/**< painted over */
+      s->drawnCol[n] = col;
+      s->drawnRow[n++] = row;
+    }
+    s->drawnCount = n;
+  }
+}
@@ -0,0 +1,67 @@
+/** \file lcdsprite.h
+ *  \brief Cell sprites over a grid, with background restore
+ *
+ *  A sprite is a list of cells of a grid (a tetris piece, a ghost
+ *  piece, a cursor) drawn solid or as an outline.  The application
+ *  moves or reshapes its sprites and calls spriteUpdate, which compares
+ *  what is on screen with what should be and repaints only the cells
+ *  that changed: uncovered cells from the background callback, newly
+ *  covered ones from the topmost sprite.  Cells that stay the same are
+ *  not touched.
+ */
+
+#ifndef lcdsprite_included
+#define lcdsprite_included
+
+#include "lcdutils.h"
+
+#define SPRITE_CELLS 4		/**< most cells in one sprite */
+
+#define SPRITE_SOLID   0	/**< cells filled with the color */
+#define SPRITE_OUTLINE 1	/**< 1-pixel outline over the background */
+
+/** One sprite; set the public fields, then call spriteUpdate */
+typedef struct {
+  signed char col, row;		/**< position, in cells */
+  const signed char *dx, *dy;	/**< cell offsets from col,row */
+  u_char count;			/**< cells (<= SPRITE_CELLS; 0 hides it) */
+  u_char style;			/**< SPRITE_SOLID or SPRITE_OUTLINE */
+  u_int color;			/**< BGR */
+  /** What is on screen (private) */
+  signed char drawnCol[SPRITE_CELLS], drawnRow[SPRITE_CELLS];
+  u_char drawnCount, drawnStyle;
+  u_int drawnColor;
+} Sprite;
+
+/** A grid and the sprites over it, bottom to top */
+typedef struct {
+  u_char col, row;		/**< screen position of cell (0,0) */
+  u_char cellWidth, cellHeight;	/**< cell size in pixels */
+  u_char cols, rows;		/**< grid size; cells outside are not drawn */
+  /** BGR color of grid cell col,row when no sprite covers it */
+  u_int (*background)(const void *ctx, u_char col, u_char row);
+  const void *ctx;		/**< passed to background */
+  Sprite *sprites;
+  u_char numSprites;
+} SpriteLayer;
+
+/** Repaint the cells whose content changed since the last update
+ *
+ *  \param layer The grid and its sprites
+ */
+void spriteUpdate(const SpriteLayer *layer);
+
+/** The application repainted grid cells col0..col1 x row0..row1 from
+ *  the background (e.g. redrew rows after a change): sprite cells drawn
+ *  there are gone, so the next update neither restores nor skips them
+ *
+ *  \param layer The grid and its sprites
+ *  \param col0 First column
+ *  \param row0 First row
+ *  \param col1 Last column
+ *  \param row1 Last row
+ */
+void spriteForgetArea(const SpriteLayer *layer, u_char col0, u_char row0,
+		      u_char col1, u_char row1);
+
+#endif // included
@@ -0,0 +1,57 @@
+/** \file lcdtiles.c
+ *  \brief Tile map renderer: a region of solid-color tiles in one window
+ */
+#include "lcdutils.h"
+#include "lcdtiles.h"
+
+/** Color of one scanline pixel with overlays (private) */
+static u_int
+tile_overlay(u_int color, u_char col, u_char row,
+	     const TileSprite *sprites, u_char numSprites)
+{
+  for (; numSprites; numSprites--, sprites++)
+    if (col >= sprites->col && col < sprites->col + sprites->width &&
+	row >= sprites->row && row < sprites->row + sprites->height)
+      color = sprites->color;
+  return color;
+}
+
+void
+drawTileMap(const TileMap *map, u_char firstRow, u_char lastRow,
+	    const TileSprite *sprites, u_char numSprites)
+{
+  u_char rowTiles[TILEMAP_MAX_COLS];
+  const u_char *tiles = rowTiles;
+  u_char tw = map->tileWidth, cols = map->cols;
+  u_char row = map->row + firstRow * map->tileHeight;
+  u_char r, y, c, x, k;
+
+  lcd_setArea(map->col, row, map->col + cols * tw - 1,
+	      map->row + (lastRow + 1) * map->tileHeight - 1);
+  for (r = firstRow; r <= lastRow; r++) {
+    if (map->tiles)
+      tiles = map->tiles + r * cols;
+    else
+      map->rowTiles(map->ctx, r, rowTiles);
+    for (y = map->tileHeight; y; y--, row++) {
+      /* overlays on this scanline? */
+      for (k = 0; k < numSprites; k++)
+	if (row >= sprites[k].row && row < sprites[k].row + sprites[k].height)
+	  break;
+      if (k == numSprites) {
+	for (c = 0; c < cols; c++) {
+	  u_int color = map->palette[tiles[c]];
+	  for (x = tw; x; x--)
+	    lcd_writeColor(color);
+	}
+      } else {
+	u_char col = map->col;
+	for (c = 0; c < cols; c++) {
+	  u_int color = map->palette[tiles[c]];
+	  for (x = tw; x; x--, col++)
+	    lcd_writeColor(tile_overlay(color, col, row, sprites, numSprites));
+	}
+      }
+    }
+  }
+}
@@ -0,0 +1,48 @@
+/** \file lcdtiles.h
+ *  \brief Tile map renderer: a region of solid-color tiles in one window
+ *
+ *  drawTileMap opens a single window over whole rows of the map and
+ *  streams every pixel once, in raster order: no clear before, no
+ *  window per block, no overdraw.  An optional list of overlay
+ *  rectangles is painted over the tiles in the same pass.
+ */
+
+#ifndef lcdtiles_included
+#define lcdtiles_included
+
+#include "lcdutils.h"
+
+/** Most tiles in a map row (size of the row buffer on the stack) */
+#define TILEMAP_MAX_COLS 32
+
+/** A grid of tile indices; tile i is filled with palette[i] */
+typedef struct {
+  u_char col, row;		/**< screen position of tile (0,0) */
+  u_char tileWidth, tileHeight;	/**< tile size in pixels */
+  u_char cols, rows;		/**< map size in tiles (cols <= TILEMAP_MAX_COLS) */
+  const u_int *palette;		/**< BGR color of each tile index */
+  const u_char *tiles;		/**< row-major indices, or 0 to use rowTiles */
+  /** Fill tiles[0..cols-1] with the indices of map row `row` (for
+   *  maps computed on the fly instead of stored); ctx is passed back */
+  void (*rowTiles)(const void *ctx, u_char row, u_char *tiles);
+  const void *ctx;
+} TileMap;
+
+/** Overlay rectangle, in screen pixels */
+typedef struct {
+  u_char col, row, width, height;
+  u_int color;
+} TileSprite;
+
+/** Draw map rows firstRow..lastRow in one window
+ *
+ *  \param map The tile map
+ *  \param firstRow First map row to draw
+ *  \param lastRow Last map row to draw
+ *  \param sprites Overlays, painted in order over the tiles (or 0)
+ *  \param numSprites Number of overlays
+ */
+void drawTileMap(const TileMap *map, u_char firstRow, u_char lastRow,
+		 const TileSprite *sprites, u_char numSprites);
+
+#endif // included
@@ -42,7 +42,9 @@ u_char _orientation = 0;
 
 /** LCD driver IC specific defines */
 #define SWRESET							0x01
+#define	SLEEPIN							0x10
 #define	SLEEPOUT						0x11
+#define DISPOFF							0x28
 #define DISPON							0x29
 #define CASETP							0x2A
 #define PASETP							0x2B
@@ -115,47 +117,100 @@ void _delay(u_char x10ms) {
 	}
 }
 
+/** Last window sent; the panel keeps it until changed, so a range
+ *  equal to the previous one is not sent again.  Start > end never
+ *  matches a real request. */
+static u_char areaCol[2] = {1, 0}, areaRow[2] = {1, 0};
+
 /** Set area to draw to */
 void lcd_setArea(u_char colStart, u_char rowStart, u_char colEnd, u_char rowEnd) 
 {
-	_writeCommand(CASETP);
-	lcd_writeData(0);
-	lcd_writeData(colStart);
-	lcd_writeData(0);
-	lcd_writeData(colEnd);
-	_writeCommand(PASETP);
-	lcd_writeData(0);
-	lcd_writeData(rowStart);
-	lcd_writeData(0);
-	lcd_writeData(rowEnd);
+	if (colStart != areaCol[0] || colEnd != areaCol[1]) {
+		_writeCommand(CASETP);
+		lcd_writeData(0);
+		lcd_writeData(colStart);
+		lcd_writeData(0);
+		lcd_writeData(colEnd);
+		areaCol[0] = colStart;
+		areaCol[1] = colEnd;
+	}
+	if (rowStart != areaRow[0] || rowEnd != areaRow[1]) {
+		_writeCommand(PASETP);
+		lcd_writeData(0);
+		lcd_writeData(rowStart);
+		lcd_writeData(0);
+		lcd_writeData(rowEnd);
+		areaRow[0] = rowStart;
+		areaRow[1] = rowEnd;
+	}
 	_writeCommand(RAMWRP);
 }
 
-/** Initialize onboard LCD */
-void lcd_init() 
+/** MADCTL value for the compile-time orientation */
+#if ORIENTATION == ORIENTATION_HORIZONTAL
+# define MADCTL_ORIENTATION	0x68
+#elif ORIENTATION == ORIENTATION_VERTICAL_ROTATED
+# define MADCTL_ORIENTATION	0x08
+#elif ORIENTATION == ORIENTATION_HORIZONTAL_ROTATED
+# define MADCTL_ORIENTATION	0xA8
+#else
+# define MADCTL_ORIENTATION	0xC8
+#endif
+
+/** Init sequence: command, argument count, arguments.  When the count
+ *  has INIT_DELAY set, a delay in ms follows the arguments.
+ *  Delays are the ST7735 datasheet minimums.
+ */
+#define INIT_DELAY 0x80
+static const u_char initCmds[] = {
+  SWRESET, INIT_DELAY, 120,	/**< software reset; 120ms before SLPOUT */
+  SLEEPOUT, INIT_DELAY, 5,	/**< exit sleep; 5ms before next command */
+  COLMOD, 1, 0x05,		/**< Set Color Format 16bit */
+  DISPON, 0,			/**< display ON */
+  MADCTL, 1, MADCTL_ORIENTATION,
+};
+
+static const u_char *initPos = initCmds + sizeof initCmds;
+
+/** Send init table entries until one asks for a delay (private; also
+ *  used by lcdinit.c)
+ *
+ *  \param restart Nonzero to set up the SPI port and start the table over
+ *  \return The delay in ms, 0 once the table is done
+ */
+u_char _initStep(u_char restart)
 {
-  setUpSPIforLCD();
-  _writeCommand(SWRESET);  /**< software reset */
-  _delay(20);
-  _writeCommand(SLEEPOUT); /**< exit sleep */
-  _delay(20);
-  _writeCommand(COLMOD);   /**< Set Color Format 16bit */
-  lcd_writeData(0x05);
-  _writeCommand(DISPON);   /**< display ON */
-
-  _writeCommand(MADCTL);
-  switch (ORIENTATION) {
-  case ORIENTATION_HORIZONTAL:
-    lcd_writeData(0x68);
-    break;
-  case ORIENTATION_VERTICAL_ROTATED:
-    lcd_writeData(0x08);
-    break;
-  case ORIENTATION_HORIZONTAL_ROTATED:
-    lcd_writeData(0xA8);
-    break;
-  default:
-    lcd_writeData(0xC8);
+  if (restart) {
+    setUpSPIforLCD();
+    areaCol[0] = areaRow[0] = 1;	/**< reset: forget the window */
+    areaCol[1] = areaRow[1] = 0;
+    initPos = initCmds;
+  }
+  while (initPos < initCmds + sizeof initCmds) {
+    u_char argc;
+    _writeCommand(*initPos++);
+    argc = *initPos++;
+    for (u_char i = argc & ~INIT_DELAY; i; i--)
+      lcd_writeData(*initPos++);
+    if (argc & INIT_DELAY)
+      return *initPos++;
   }
+  return 0;
 }
 
+/** Turn the display off and put the panel to sleep */
+void lcd_sleep()
+{
+  _writeCommand(DISPOFF);
+  _writeCommand(SLEEPIN);
+  while (UCB0STAT & UCBUSY);	/**< let the last byte out before SMCLK stops */
+}
+
+/** Initialize onboard LCD (busy-waits through the delays; lcdinit.c
+ *  has the interrupt-driven version) */
+void lcd_init() 
+{
+  u_char ms;
+  for (ms = _initStep(1); ms; ms = _initStep(0))
+    _delay((ms + 9) / 10);
+}
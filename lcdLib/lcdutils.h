@@ -14,6 +14,25 @@ extern const unsigned char font_5x7[96][5];
 extern const unsigned char font_8x12[95][12];
 extern const unsigned int font_11x16[95][11];
 
+/** font_5x7 bit-packed, possibly only the characters an app prints
+ *
+ *  Glyph g is bits 35g..35g+34 of bits (LSB first): 7 rows of each of
+ *  the 5 columns.  lcdLib's copy has every character; an app links its
+ *  own subset from fontgen before libLcd.a to replace it.
+ */
+typedef struct {
+  u_char first, last;		/**< characters first..last */
+  const u_char *index;		/**< glyph of each, FONT_MISSING if absent; 0: all present */
+  const u_char *bits;		/**< the glyphs, 35 bits each */
+} Font5x7;
+#define FONT_MISSING 0xff	/**< drawn as a space */
+
+extern const Font5x7 font5x7;
+
+/** Unpack character c of font5x7: 5 bytes, one per column, bit = row
+ *  (lcddraw.c) */
+void font5x7Glyph(char c, u_char *glyph);
+
 
 
 /** Orientation */
@@ -37,9 +56,17 @@ extern const unsigned int font_11x16[95][11];
 # define screenWidth LONG_EDGE_PIXELS
 #endif
 
-/** Initialize the onboard LCD */
+/** Initialize the onboard LCD (blocks until the panel is ready; see
+ *  lcdinit.h for a version that does not) */
 void lcd_init();
 
+/** Turn the display off and put the panel in sleep mode (before LPM4)
+ *
+ *  The panel keeps no image worth having: wake it with lcd_init (or
+ *  lcd_init_start) and redraw the whole screen.
+ */
+void lcd_sleep();
+
 /** Set area to draw to
  *  
  *  \param colStart Start column of the area
@@ -1,52 +1,44 @@
 #include <msp430.h>
 #include <libTimer.h>
-#include <string.h>
-#include <stdlib.h>     // for rand(), srand()
 #include "lcdutils.h"
 #include "lcddraw.h"
+#include "lcdlist.h"
+#include "lcdtiles.h"
+#include "lcdsprite.h"
+#include "lcdformat.h"
+#include "lcdshadow.h"
+#include "tetrisEngine.h"
 
 // --------------------------------------------------
 // Configuración de pantalla y rejilla
 // --------------------------------------------------
 #define SCREEN_WIDTH   128
 #define SCREEN_HEIGHT  160
-#define BLOCK_SIZE     10
+#ifndef BLOCK_SIZE
+#define BLOCK_SIZE     10      // tamaño de bloque en píxeles (make BLOCK_SIZE=n)
+#endif
 
 #define MAX_COLUMNS    (SCREEN_WIDTH  / BLOCK_SIZE)
 #define MAX_ROWS       (SCREEN_HEIGHT / BLOCK_SIZE)
+#define HUD_ROWS       ((8 + BLOCK_SIZE - 1) / BLOCK_SIZE)  // filas bajo el texto
 
-// --------------------------------------------------
-// Formas Tetris (4 offsets cada una)
-// --------------------------------------------------
-typedef struct { short x, y; } Offset;
-const Offset shapes[][4] = {
-  {{0,0},{1,0},{0,1},{1,1}},  // cuadrado
-  {{0,0},{1,0},{2,0},{3,0}},  // línea
-  {{0,0},{0,1},{1,1},{2,1}},  // L invertida
-  {{1,0},{0,1},{1,1},{2,1}}   // T
-};
-#define NUM_SHAPES  (sizeof(shapes)/sizeof(shapes[0]))
+#if MAX_COLUMNS != TETRIS_COLS || MAX_ROWS != TETRIS_ROWS
+#error "compilar tetrisLib con TETRIS_COLS/TETRIS_ROWS según BLOCK_SIZE (ver Makefile)"
+#endif
+#if TETRIS_COLS > TILEMAP_MAX_COLS
+#error "tablero más ancho que TILEMAP_MAX_COLS (lcdtiles.h)"
+#endif
 
 // --------------------------------------------------
 // Variables globales
 // --------------------------------------------------
-static signed char grid[MAX_COLUMNS][MAX_ROWS]; // índice de forma o -1
-static const int numColumns = MAX_COLUMNS;
-static const int numRows    = MAX_ROWS;
+static Tetris game;               // estado del juego (tetrisLib)
 
 enum { FALSE = 0, TRUE = 1 };
 volatile int redrawScreen     = TRUE;
 volatile int pieceStoppedFlag = FALSE;
 
-static short shapeCol, shapeRow;
-static char  shapeIndex    = 0;
-static char  shapeRotation = 0;
-
-static short lastCol = 0, lastRow = 0;
-static char  lastIdx  = -1;
-static char  lastRot  = 0;
-
-static int score = 0;             // puntaje actual
+static Sprite piece;              // pieza móvil (sprite de lcdLib)
 
 // --------------------------------------------------
 // Contador para pulsación larga en SW2 (~3s)
@@ -56,128 +48,175 @@ static int sw2HoldCount = 0;
 // --------------------------------------------------
 // Colores
 // --------------------------------------------------
-unsigned short shapeColors[NUM_SHAPES] = {
-  COLOR_RED, COLOR_GREEN, COLOR_ORANGE, COLOR_BLUE
-};
 #define BG_COLOR      COLOR_BLACK
+// el último es el fondo: también es la paleta del mapa de celdas
+u_int shapeColors[NUM_SHAPES + 1] = {
+  COLOR_RED, COLOR_GREEN, COLOR_ORANGE, COLOR_BLUE, BG_COLOR
+};
 
 // --------------------------------------------------
 // Prototipos
 // --------------------------------------------------
-static void draw_piece(short col, short row, char idx, char rot, unsigned short color);
-static void draw_grid(void);
-static void clear_full_rows(void);
-static void draw_score_label(void);
-static void itoa_simple(int val, char *buf);
+static void draw_board(const Tetris *g);
+static void draw_rows(const Tetris *g, int top, int bottom);
+static void draw_score_label(const Tetris *g);
+static void draw_score_text(const Tetris *g);
 static char switch_update_interrupt_sense(void);
 void switch_init(void);
 void switch_interrupt_handler(void);
 
+// Callbacks de dibujo para el motor
+static const TetrisRenderer lcdRenderer = {
+  draw_board, draw_rows, draw_score_label
+};
+
 // --------------------------------------------------
-// Convierte entero a texto simple (base 10)
+// Texto "SCORE:" y el valor en la esquina superior izquierda, sin
+// fondo: encima de los bloques, sin taparlos
 // --------------------------------------------------
-static void itoa_simple(int val, char *buf) {
-  int i = 0;
-  if (val == 0) {
-    buf[i++] = '0';
-  } else {
-    char tmp[6]; int t = 0;
-    while (val > 0 && t < 5) {
-      tmp[t++] = '0' + (val % 10);
-      val /= 10;
-    }
-    while (t--) buf[i++] = tmp[t];
-  }
-  buf[i] = '\0';
+static void draw_score_text(const Tetris *g) {
+  drawFormat5x7Transparent(0, 0, COLOR_WHITE, "SCORE:%d", g->score);
 }
 
 // --------------------------------------------------
-// Dibuja el texto "SCORE:" y el valor en la esquina superior izquierda
+// Puntaje nuevo: repone los bloques bajo el texto (draw_rows vuelve
+// a escribirlo encima)
 // --------------------------------------------------
-static void draw_score_label(void) {
-  fillRectangle(0, 0, SCREEN_WIDTH, 8, BG_COLOR);
-  char buf[6];
-  itoa_simple(score, buf);
-  drawString5x7(0, 0, "SCORE:", COLOR_WHITE, BG_COLOR);
-  drawString5x7(6*5, 0, buf, COLOR_WHITE, BG_COLOR);
+static void draw_score_label(const Tetris *g) {
+  draw_rows(g, 0, HUD_ROWS - 1);
 }
 
 // --------------------------------------------------
-// Dibuja una pieza con rotación
+// Color de una celda sin sprites: su bloque fijo o el fondo
 // --------------------------------------------------
-static void draw_piece(short col, short row, char idx, char rot, unsigned short color) {
-  for (int i = 0; i < 4; i++) {
-    int ox = shapes[idx][i].x;
-    int oy = shapes[idx][i].y;
-    int rx, ry;
-    switch(rot) {
-      case 0: rx = ox;  ry = oy;  break;
-      case 1: rx = -oy; ry = ox;  break;
-      case 2: rx = -ox; ry = -oy; break;
-      case 3: rx = oy;  ry = -ox; break;
-      default: rx = ox; ry = oy; break;
-    }
-    fillRectangle(col + rx*BLOCK_SIZE,
-                  row + ry*BLOCK_SIZE,
-                  BLOCK_SIZE, BLOCK_SIZE,
-                  color);
-  }
+static u_int board_color(const void *g, u_char c, u_char r) {
+  int idx = tetris_cell(g, c, r);
+  return shapeColors[idx >= 0 ? idx : NUM_SHAPES];
 }
 
+static const SpriteLayer spriteLayer = {
+  0, 0, BLOCK_SIZE, BLOCK_SIZE, TETRIS_COLS, TETRIS_ROWS,
+  board_color, &game, &piece, 1
+};
+
+#if SHADOW_BYTES(TETRIS_COLS, TETRIS_ROWS) <= 160
+// Lo que muestra cada celda del tablero (4 bits): draw_rows solo
+// repinta las que cambian.  El tablero denso no cabe en RAM.
+#define SHADOW
+static u_char shadowCells[SHADOW_BYTES(TETRIS_COLS, TETRIS_ROWS)];
+static const ShadowGrid shadow = {
+  0, 0, BLOCK_SIZE, BLOCK_SIZE, TETRIS_COLS, TETRIS_ROWS, shapeColors, shadowCells
+};
+#endif
+
 // --------------------------------------------------
-// Dibuja todas las piezas estáticas en la rejilla
+// Índices de mosaico de una fila: la forma, o NUM_SHAPES (fondo)
 // --------------------------------------------------
-static void draw_grid(void) {
-  for (int c = 0; c < numColumns; c++) {
-    for (int r = 0; r < numRows; r++) {
-      signed char idx = grid[c][r];
-      if (idx >= 0) {
-        fillRectangle(c*BLOCK_SIZE,
-                      r*BLOCK_SIZE,
-                      BLOCK_SIZE, BLOCK_SIZE,
-                      shapeColors[idx]);
-      }
-    }
+static void row_tiles(const void *g, u_char r, u_char *tiles) {
+  for (int c = 0; c < TETRIS_COLS; c++) {
+    int idx = tetris_cell(g, c, r);
+    tiles[c] = idx >= 0 ? idx : NUM_SHAPES;
   }
 }
 
 // --------------------------------------------------
-// Elimina filas completas, actualiza puntaje y recoloca las de arriba
+// Redibuja las filas fijas top..bottom (bloques y fondo).  Con la
+// sombra, solo las celdas que cambian, un rectángulo por tramo del
+// mismo color; si no, como mapa de celdas: una sola ventana, cada
+// píxel una vez.  Tapa lo que hubiera de los sprites en esas filas;
+// si tapa el texto, lo repite.
 // --------------------------------------------------
-static void clear_full_rows(void) {
-  for (int r = 0; r < numRows; r++) {
-    int full = TRUE;
-    for (int c = 0; c < numColumns; c++) {
-      if (grid[c][r] < 0) { full = FALSE; break; }
-    }
-    if (full) {
-      score += 5;
-      for (int rr = r; rr > 0; rr--)
-        for (int c = 0; c < numColumns; c++)
-          grid[c][rr] = grid[c][rr-1];
-      for (int c = 0; c < numColumns; c++)
-        grid[c][0] = -1;
-      clearScreen(BG_COLOR);
-      draw_grid();
-      draw_score_label();
-      r--;
-    }
+static void draw_rows(const Tetris *g, int top, int bottom) {
+#ifdef SHADOW
+  u_char tiles[TETRIS_COLS];
+  // bajo la pieza y el texto la pantalla no es el tablero
+  for (int i = 0; i < piece.drawnCount; i++) {
+    int c = piece.drawnCol[i], r = piece.drawnRow[i];
+    if (r >= top && r <= bottom) shadowInvalidate(&shadow, c, r, c, r);
+  }
+  if (top < HUD_ROWS)
+    shadowInvalidate(&shadow, 0, top, TETRIS_COLS - 1, bottom < HUD_ROWS ? bottom : HUD_ROWS - 1);
+  for (int r = top; r <= bottom; r++) {
+    row_tiles(g, r, tiles);
+    shadowSetRow(&shadow, r, tiles);
   }
+  shadowFlush(&shadow);
+#else
+  const TileMap map = {0, 0, BLOCK_SIZE, BLOCK_SIZE, TETRIS_COLS, TETRIS_ROWS,
+                       shapeColors, 0, row_tiles, g};
+  drawTileMap(&map, top, bottom, 0, 0);
+#endif
+  spriteForgetArea(&spriteLayer, 0, top, TETRIS_COLS - 1, bottom);
+  if (top < HUD_ROWS) draw_score_text(g);
+}
+
+// --------------------------------------------------
+// Tablero nuevo (o retomado): el tablero entero y lo que queda de
+// pantalla fuera de él, sin clearScreen previo (draw_rows ya
+// escribe el puntaje)
+// --------------------------------------------------
+static void draw_board(const Tetris *g) {
+#ifdef SHADOW
+  shadowInvalidate(&shadow, 0, 0, TETRIS_COLS - 1, TETRIS_ROWS - 1);
+#endif
+  draw_rows(g, 0, TETRIS_ROWS - 1);
+#if TETRIS_COLS * BLOCK_SIZE < SCREEN_WIDTH
+  fillRectangle(TETRIS_COLS * BLOCK_SIZE, 0,
+                SCREEN_WIDTH - TETRIS_COLS * BLOCK_SIZE, SCREEN_HEIGHT, BG_COLOR);
+#endif
+#if TETRIS_ROWS * BLOCK_SIZE < SCREEN_HEIGHT
+  fillRectangle(0, TETRIS_ROWS * BLOCK_SIZE,
+                TETRIS_COLS * BLOCK_SIZE, SCREEN_HEIGHT - TETRIS_ROWS * BLOCK_SIZE, BG_COLOR);
+#endif
+}
+
+// --------------------------------------------------
+// ¿Tiene la pieza alguna celda dibujada bajo el texto?
+// --------------------------------------------------
+static int piece_under_text(void) {
+  for (int i = 0; i < piece.drawnCount; i++)
+    if (piece.drawnRow[i] < HUD_ROWS) return TRUE;
+  return FALSE;
 }
 
 // --------------------------------------------------
-// Actualiza la pieza móvil
+// Actualiza la pieza móvil: solo las celdas que deja (con su bloque
+// fijo o el fondo) y las que ocupa, por una lista de dibujo.  Si
+// entra o sale de las filas del texto, lo vuelve a escribir encima.
+// Sin interrupciones: la gravedad y los botones dibujan filas desde
+// sus ISR, que no deben caer en la lista ni ver los sprites a medias.
 // --------------------------------------------------
 static void update_moving_shape(void) {
-  if (lastIdx >= 0) {
-    draw_piece(lastCol, lastRow, lastIdx, lastRot, BG_COLOR);
+  const PieceRot *p;
+  DlOp ops[8];
+  int underText;
+
+  and_sr(~0x8);
+  p = &pieceTable[(int)game.shape][(int)game.rot];
+  underText = piece_under_text();
+
+  piece.col = game.col;
+  piece.row = game.row;
+  piece.dx = p->dx;
+  piece.dy = p->dy;
+  piece.count = 4;
+  piece.color = shapeColors[(int)game.shape];
+
+  dlBegin(ops, 8);
+  spriteUpdate(&spriteLayer);
+  dlEnd();
+  if (underText || piece_under_text()) draw_score_text(&game);
+  or_sr(0x8);
+}
+
+// --------------------------------------------------
+// Resultado de un paso del motor
+// --------------------------------------------------
+static void handle_events(int events) {
+  if (events & (TETRIS_LOCKED | TETRIS_NEWGAME)) {
+    pieceStoppedFlag = TRUE;
   }
-  draw_piece(shapeCol, shapeRow, shapeIndex, shapeRotation,
-             shapeColors[shapeIndex]);
-  lastCol = shapeCol;
-  lastRow = shapeRow;
-  lastIdx = shapeIndex;
-  lastRot = shapeRotation;
+  if (events) redrawScreen = TRUE;
 }
 
 // --------------------------------------------------
@@ -207,74 +246,12 @@ void switch_interrupt_handler(void) {
   char p2val = switch_update_interrupt_sense();
   switches = ~p2val & SWITCHES;
 
-  if (lastIdx >= 0)
-    draw_piece(lastCol, lastRow, lastIdx, lastRot, BG_COLOR);
-
-  // SW1: mover izquierda
-  if (switches & (1<<0)) {
-    short newCol = shapeCol - BLOCK_SIZE;
-    int valid = TRUE;
-    for (int i = 0; i < 4; i++) {
-      int ox = shapes[shapeIndex][i].x;
-      int oy = shapes[shapeIndex][i].y;
-      int rx = (shapeRotation==1?-oy:shapeRotation==2?-ox:shapeRotation==3?oy:ox);
-      int ry = (shapeRotation==1?ox:shapeRotation==2?-oy:shapeRotation==3?-ox:oy);
-      int c = (newCol + rx*BLOCK_SIZE)/BLOCK_SIZE;
-      int r = (shapeRow + ry*BLOCK_SIZE)/BLOCK_SIZE;
-      if (c<0 || (r>=0 && grid[c][r]>=0)) { valid=FALSE; break; }
-    }
-    if (valid) shapeCol = newCol;
-  }
-
-  // SW2: rotar (pulsación corta)
-  if ((switches & (1<<1)) && sw2HoldCount == 0) {
-    char newRot = (shapeRotation + 1) % 4;
-    int valid = TRUE;
-    for (int i = 0; i < 4; i++) {
-      int ox = shapes[shapeIndex][i].x;
-      int oy = shapes[shapeIndex][i].y;
-      int rx = (newRot==1?-oy:newRot==2?-ox:newRot==3?oy:ox);
-      int ry = (newRot==1?ox:newRot==2?-oy:newRot==3?-ox:oy);
-      int c = (shapeCol + rx*BLOCK_SIZE)/BLOCK_SIZE;
-      int r = (shapeRow + ry*BLOCK_SIZE)/BLOCK_SIZE;
-      if (c<0 || c>=numColumns || r>=numRows || (r>=0 && grid[c][r]>=0)) {
-        valid = FALSE; break;
-      }
-    }
-    if (valid) shapeRotation = newRot;
-  }
-
-  // SW3: reiniciar manual
-  if (switches & (1<<2)) {
-    clearScreen(BG_COLOR);
-    memset(grid, -1, sizeof grid);
-    score = 0;
-    srand(TA0R);
-    shapeRotation = 0;
-    shapeIndex = rand() % NUM_SHAPES;
-    shapeCol = ((numColumns / 2) - 1) * BLOCK_SIZE;
-    shapeRow = -BLOCK_SIZE * 4;
-    draw_score_label();
-    sw2HoldCount = 0;
-  }
-
-  // SW4: mover derecha
-  if (switches & (1<<3)) {
-    short newCol = shapeCol + BLOCK_SIZE;
-    int valid = TRUE;
-    for (int i = 0; i < 4; i++) {
-      int ox = shapes[shapeIndex][i].x;
-      int oy = shapes[shapeIndex][i].y;
-      int rx = (shapeRotation==1?-oy:shapeRotation==2?-ox:shapeRotation==3?oy:ox);
-      int ry = (shapeRotation==1?ox:shapeRotation==2?-oy:shapeRotation==3?-ox:oy);
-      int c = (newCol + rx*BLOCK_SIZE)/BLOCK_SIZE;
-      int r = (shapeRow + ry*BLOCK_SIZE)/BLOCK_SIZE;
-      if (c>=numColumns || (r>=0 && grid[c][r]>=0)) { valid=FALSE; break; }
-    }
-    if (valid) shapeCol = newCol;
-  }
+  // SW1: izquierda, SW2: rotar (pulsación corta), SW3: caída inmediata, SW4: derecha
+  // (SW2 largo es partida nueva: SW3 ya no reinicia, ver README)
+  char input = switches;
+  if (sw2HoldCount) input &= ~TETRIS_ROTATE;
+  handle_events(tetris_step(&game, input, FALSE));
 
-  redrawScreen = TRUE;
   P2IFG = 0;
   P2IE |= SWITCHES;
 }
@@ -288,7 +265,7 @@ void __interrupt_vec(PORT2_VECTOR) Port_2(void) {
 }
 
 // --------------------------------------------------
-// WDT: caída, apilamiento, game over, pulsación larga
+// WDT: caída y pulsación larga
 // --------------------------------------------------
 void wdt_c_handler(void) {
   static int tick = 0;
@@ -299,74 +276,16 @@ void wdt_c_handler(void) {
   if (!(P2IN & (1<<1))) {
     sw2HoldCount++;
     if (sw2HoldCount >= 3) {
-      clearScreen(BG_COLOR);
-      memset(grid, -1, sizeof grid);
-      score = 0;
-      srand(TA0R);
-      shapeRotation = 0;
-      shapeIndex = rand() % NUM_SHAPES;
-      shapeCol = ((numColumns / 2) - 1) * BLOCK_SIZE;
-      shapeRow = -BLOCK_SIZE * 4;
-      draw_score_label();
       sw2HoldCount = 0;
+      handle_events(tetris_step(&game, TETRIS_RESET, FALSE));
       return;
     }
   } else {
     sw2HoldCount = 0;
   }
 
-  // Caída normal
-  short newRow = shapeRow + BLOCK_SIZE;
-  int collided = FALSE;
-  for (int i = 0; i < 4; i++) {
-    int ox = shapes[shapeIndex][i].x;
-    int oy = shapes[shapeIndex][i].y;
-    int rx = (shapeRotation==1?-oy:shapeRotation==2?-ox:shapeRotation==3?oy:ox);
-    int ry = (shapeRotation==1?ox:shapeRotation==2?-oy:shapeRotation==3?-ox:oy);
-    int c = (shapeCol + rx*BLOCK_SIZE)/BLOCK_SIZE;
-    int r = (newRow + ry*BLOCK_SIZE)/BLOCK_SIZE;
-    if (r>=numRows || (r>=0 && grid[c][r]>=0)) { collided = TRUE; break; }
-  }
-
-  if (!collided) {
-    shapeRow = newRow;
-  } else {
-    // Game over si colisiona encima del tope
-    if (shapeRow < 0) {
-      clearScreen(BG_COLOR);
-      memset(grid, -1, sizeof grid);
-      score = 0;
-      srand(TA0R);
-      shapeRotation = 0;
-      shapeIndex = rand() % NUM_SHAPES;
-      shapeCol = ((numColumns / 2) - 1) * BLOCK_SIZE;
-      shapeRow = -BLOCK_SIZE * 4;
-      draw_score_label();
-      return;
-    }
-    // Fijar pieza actual
-    for (int i = 0; i < 4; i++) {
-      int ox = shapes[shapeIndex][i].x;
-      int oy = shapes[shapeIndex][i].y;
-      int rx = (shapeRotation==1?-oy:shapeRotation==2?-ox:shapeRotation==3?oy:ox);
-      int ry = (shapeRotation==1?ox:shapeRotation==2?-oy:shapeRotation==3?-ox:oy);
-      int c = (shapeCol + rx*BLOCK_SIZE)/BLOCK_SIZE;
-      int r = (shapeRow + ry*BLOCK_SIZE)/BLOCK_SIZE;
-      if (r >= 0 && r < numRows) grid[c][r] = shapeIndex;
-    }
-    draw_grid();
-    clear_full_rows();
-    pieceStoppedFlag = TRUE;
-    lastIdx = -1;
-
-    // Generar nueva pieza
-    shapeIndex = rand() % NUM_SHAPES;
-    shapeRotation = 0;
-    shapeCol = ((numColumns / 2) - 1) * BLOCK_SIZE;
-    shapeRow = -BLOCK_SIZE * 4;
-  }
-
-  redrawScreen = TRUE;
+  // Caída normal (el motor fija la pieza, limpia filas y reinicia)
+  handle_events(tetris_step(&game, 0, TRUE));
 }
 
 // --------------------------------------------------
@@ -377,19 +296,9 @@ int main(void) {
   P1OUT |= BIT6;
   configureClocks();
   lcd_init();
-  clearScreen(BG_COLOR);
-  score = 0;
-  draw_score_label();
-
-  // Inicializar generador de números
-  srand(TA0R);
-  shapeIndex = rand() % NUM_SHAPES;
 
   switch_init();
-  memset(grid, -1, sizeof grid);
-  shapeRotation = 0;
-  shapeCol = ((numColumns / 2) - 1) * BLOCK_SIZE;
-  shapeRow = -BLOCK_SIZE * 4;
+  tetris_init(&game, TA0R, &lcdRenderer);
 
   enableWDTInterrupts();
   or_sr(0x8);
@@ -1,254 +1,403 @@
 #include <msp430.h>
 #include <libTimer.h>
-#include <string.h>
 #include "lcdutils.h"
+#include "lcdinit.h"
 #include "lcddraw.h"
+#include "lcdlist.h"
+#include "lcdtiles.h"
+#include "lcdsprite.h"
+#include "lcdformat.h"
+#include "lcdshadow.h"
+#include "tetrisEngine.h"
+#include "tetrisReplay.h"
+#include "tetrisBot.h"
+#include "flashStore.h"
 
 // --------------------------------------------------
 // Configuración de pantalla y rejilla
 // --------------------------------------------------
 #define SCREEN_WIDTH   128
 #define SCREEN_HEIGHT  160
-#define BLOCK_SIZE     8
+#ifndef BLOCK_SIZE
+#define BLOCK_SIZE     8      // tamaño de bloque en píxeles (make BLOCK_SIZE=n)
+#endif
 
 #define MAX_COLUMNS    (SCREEN_WIDTH  / BLOCK_SIZE)
 #define MAX_ROWS       (SCREEN_HEIGHT / BLOCK_SIZE)
 
-// --------------------------------------------------
-// Formas Tetris (4 offsets cada una)
-// --------------------------------------------------
-typedef struct { short x, y; } Offset;
-const Offset shapes[][4] = {
-  {{0,0},{1,0},{0,1},{1,1}},  // cuadrado
-  {{0,0},{1,0},{2,0},{3,0}},  // línea
-  {{0,0},{0,1},{1,1},{2,1}},  // L invertida
-  {{1,0},{0,1},{1,1},{2,1}}   // T
-};
-#define NUM_SHAPES  (sizeof(shapes)/sizeof(shapes[0]))
-
-// --------------------------------------------------
-// Bolsa “8-bag” (2 copias de cada) para spawn sin patrones
-// --------------------------------------------------
-#define BAG_MULT   2
-#define BAG_SIZE   (NUM_SHAPES * BAG_MULT)
-static unsigned char bag[BAG_SIZE];
-static int bagPos = BAG_SIZE;  // fuerza refill inicial
+#if MAX_COLUMNS != TETRIS_COLS || MAX_ROWS != TETRIS_ROWS
+#error "tetrisLib compilado con otra geometría (TETRIS_COLS/TETRIS_ROWS)"
+#endif
+#if TETRIS_COLS > TILEMAP_MAX_COLS
+#error "tablero más ancho que TILEMAP_MAX_COLS (lcdtiles.h)"
+#endif
 
 // --------------------------------------------------
 // Variables globales
 // --------------------------------------------------
-static signed char grid[MAX_COLUMNS][MAX_ROWS]; // índice de forma o -1
-static const int numColumns = MAX_COLUMNS;
-static const int numRows    = MAX_ROWS;
+static Tetris game;               // estado del juego (tetrisLib)
+
+#ifdef RECORD
+// Semilla + entradas en RAM; volcar con mspdebug: "save_raw &recBuf 96 rec.bin"
+unsigned char recBuf[96];
+static TetrisRecorder recorder;
+#endif
+#ifdef REPLAY
+// Grabación generada con "tetrisHost -c"; reemplaza a los botones
+extern const unsigned char replayLog[];
+extern const unsigned int replayLogLen;
+static TetrisReplay replayer;
+#endif
+#ifdef BOT
+#if defined(REPLAY) || defined(POWER_STATS)
+#error "BOT no se combina con REPLAY ni POWER_STATS"
+#endif
+// Jugador automático; peores tiempos medidos con TA0 en ACLK (VLO
+// medido, ~83 us): a 16 bits da la vuelta cada ~5 s, no cada 262 ms
+// como con SMCLK/8, así que ningún paso largo se informa de menos
+static TetrisBot bot;
+enum { WORST_LOCK, WORST_CLEAR, WORST_REDRAW, WORST_SLOTS };
+static unsigned int worst[WORST_SLOTS];
+#endif
+
+// Récords y partida suspendida en la info flash: solo en el juego
+// normal, y suspender solo si la instantánea cabe en un registro
+#if !defined(RECORD) && !defined(REPLAY) && !defined(BOT)
+#define PERSIST
+#if TETRIS_COLS <= 16 && TETRIS_ROWS <= 20
+#define SUSPEND
+#endif
+#endif
 
 enum { FALSE = 0, TRUE = 1 };
 volatile int redrawScreen     = TRUE;
 volatile int pieceStoppedFlag = FALSE;
 
-static short shapeCol, shapeRow;
-static char  shapeIndex    = 0;
-static char  shapeRotation = 0;
+// Pieza móvil y su fantasma (contorno en la fila de aterrizaje,
+// game.dropRow): sprites de lcdLib sobre el tablero
+static Sprite sprites[2];
+#define ghost  (sprites[0])          // debajo de la pieza
+#define piece  (sprites[1])
 
-static short lastCol = 0, lastRow = 0;
-static char  lastIdx  = -1;
-static char  lastRot  = 0;
-
-static int score = 0;             // puntaje actual
-
-unsigned short shapeColors[NUM_SHAPES] = {
-  COLOR_RED, COLOR_GREEN, COLOR_ORANGE, COLOR_BLUE
-};
 #define BG_COLOR      COLOR_BLACK
+// el último es el fondo: también es la paleta del mapa de celdas
+u_int shapeColors[NUM_SHAPES + 1] = {
+  COLOR_RED, COLOR_GREEN, COLOR_ORANGE, COLOR_BLUE, BG_COLOR
+};
 
-// --------------------------------------------------
-// Generador de pseudoaleatorios LCG
-// --------------------------------------------------
-static unsigned long randState;
+#define SWITCHES (BIT0 | BIT1 | BIT2 | BIT3)
 
 // --------------------------------------------------
 // Contador para pulsación larga en SW2 (~3s)
 // --------------------------------------------------
 static int sw2HoldCount = 0;
 
+#ifdef PERSIST
+// --------------------------------------------------
+// Tabla de récords (flashLib); SW3 largo suspende la partida
+// --------------------------------------------------
+#define TAG_HISCORES  0
+#define TAG_SNAPSHOT  1
+#define TAG_COLORS    2                   // colores de la instantánea
+#define HISCORES      5
+static int hiScores[HISCORES];            // de mayor a menor
+static volatile int gameOverDue = FALSE;
+#endif
+#ifdef SUSPEND
+static int sw3HoldCount = 0;
+static volatile int suspendDue = FALSE;
+static volatile int suspended  = FALSE;
+#endif
+
+// --------------------------------------------------
+// Contabilidad de consumo (timerLib): solo con POWER_STATS; sin ella
+// los ISR no marcan nada, TA1 queda parado y se duerme sin más
+// --------------------------------------------------
+#ifdef POWER_STATS
+#define ISR_ENTER(state)  char pwrPrev = powerIsrEnter(state)
+#define ISR_EXIT()        powerIsrExit(pwrPrev)
+#define SLEEP()           powerSleep()
+#else
+#define ISR_ENTER(state)
+#define ISR_EXIT()
+#define SLEEP()           sleep_lpm()
+static void sleep_lpm(void) {
+  if (lpmBits & 0x80)               // LPM3 para SMCLK, que también mueve el
+    while (UCB0STAT & UCBUSY);      // SPI de la pantalla: que salga el último byte
+  or_sr(lpmBits | 0x8);
+}
+#endif
+
+#if defined(POWER_STATS) || defined(BOT)
+// --------------------------------------------------
+// Informe periódico junto al puntaje (consumo o peores tiempos)
+// --------------------------------------------------
+static volatile int reportDue = FALSE;
+static void draw_report(void);
+#endif
+
 // --------------------------------------------------
 // Prototipos
 // --------------------------------------------------
-static void draw_piece(short col, short row, char idx, char rot, unsigned short color);
-static void draw_grid(void);
-static void clear_full_rows(void);
-static void draw_score_label(void);
-static void itoa_simple(int val, char *buf);
-static int rotatedX(char idx, char rot, int i);
-static int rotatedY(char idx, char rot, int i);
-static void refillBag(void);
+static void draw_board(const Tetris *g);
+static void draw_rows(const Tetris *g, int top, int bottom);
+static void draw_score_label(const Tetris *g);
 static void update_moving_shape(void);
 static char switch_update_interrupt_sense(void);
 static void switch_init(void);
 static void switch_interrupt_handler(void);
 
+// Callbacks de dibujo para el motor
+static const TetrisRenderer lcdRenderer = {
+  draw_board, draw_rows, draw_score_label
+};
+
 // --------------------------------------------------
-// Convierte entero a texto simple (base 10)
+// Dibuja "SCORE" y el valor (y el récord), en campos de ancho fijo
 // --------------------------------------------------
-static void itoa_simple(int val, char *buf) {
-  int i = 0;
-  if (val == 0) {
-    buf[i++] = '0';
-  } else {
-    char tmp[6]; int t = 0;
-    while (val > 0 && t < 5) {
-      tmp[t++] = '0' + (val % 10);
-      val /= 10;
-    }
-    while (t--) buf[i++] = tmp[t];
-  }
-  buf[i] = '\0';
+static void draw_score_label(const Tetris *g) {
+  fillRectangle(0, 0, SCREEN_WIDTH, 8, BG_COLOR);
+#if defined(PERSIST) && !defined(POWER_STATS)
+  drawFormat5x7(5, 5, COLOR_WHITE, BG_COLOR, "SCORE%5d HI:%5d", g->score, hiScores[0]);
+#else
+  drawFormat5x7(5, 5, COLOR_WHITE, BG_COLOR, "SCORE%5d", g->score);
+#endif
 }
 
+#ifdef POWER_STATS
 // --------------------------------------------------
-// Dibuja el texto "SCORE:" y el valor
+// Dibuja "A<%activo> W<despertares/s>" a la derecha del puntaje
 // --------------------------------------------------
-static void draw_score_label(void) {
-  fillRectangle(0, 0, SCREEN_WIDTH, 8, BG_COLOR);
-  char buf[6];
-  itoa_simple(score, buf);
-  drawString5x7(5, 5, "SCORE:", COLOR_WHITE, BG_COLOR);
-  drawString5x7(35, 5, buf, COLOR_WHITE, BG_COLOR);
+static void draw_report(void) {
+  PowerReport report;
+  powerStatsReport(&report);
+  fillRectangle(72, 0, SCREEN_WIDTH - 72, 8, BG_COLOR);
+  drawFormat5x7(72, 5, COLOR_WHITE, BG_COLOR, "A%3uW%u",
+                100 - report.percent[PWR_LPM], report.wakeupsPerSec);
 }
+#endif
 
+#ifdef BOT
 // --------------------------------------------------
-// Helpers de rotación
+// Dibuja "L<fijar> C<eliminar> R<redibujar>", peores tiempos en
+// décimas de ms, a la derecha del puntaje.  Dos cifras por campo (99:
+// 9.9 ms o más) para no pasar de los 128 px.
 // --------------------------------------------------
-static int rotatedX(char idx, char rot, int i) {
-  int ox = shapes[idx][i].x;
-  int oy = shapes[idx][i].y;
-  switch(rot) {
-    case 1: return -oy;
-    case 2: return -ox;
-    case 3: return oy;
-    default: return ox;
-  }
+static unsigned int tenths_ms(unsigned int ticks) {
+  unsigned long t = ticks * 10000UL / aclkHz;
+  return t > 99 ? 99 : t;
 }
-static int rotatedY(char idx, char rot, int i) {
-  int ox = shapes[idx][i].x;
-  int oy = shapes[idx][i].y;
-  switch(rot) {
-    case 1: return ox;
-    case 2: return -oy;
-    case 3: return -ox;
-    default: return oy;
-  }
+
+static void draw_report(void) {
+  fillRectangle(66, 0, SCREEN_WIDTH - 66, 8, BG_COLOR);
+  drawFormat5x7(66, 5, COLOR_WHITE, BG_COLOR, "L%2uC%2uR%2u",
+                tenths_ms(worst[WORST_LOCK]), tenths_ms(worst[WORST_CLEAR]),
+                tenths_ms(worst[WORST_REDRAW]));
 }
+#endif
 
 // --------------------------------------------------
-// Dibuja una pieza con rotación
+// Color de una celda sin sprites: su bloque fijo o el fondo
 // --------------------------------------------------
-static void draw_piece(short col, short row, char idx, char rot, unsigned short color) {
-  for (int i = 0; i < 4; i++) {
-    int rx = rotatedX(idx, rot, i);
-    int ry = rotatedY(idx, rot, i);
-    fillRectangle(col + rx*BLOCK_SIZE,
-                  row + ry*BLOCK_SIZE,
-                  BLOCK_SIZE, BLOCK_SIZE,
-                  color);
-  }
+static u_int board_color(const void *g, u_char c, u_char r) {
+  int idx = tetris_cell(g, c, r);
+  return shapeColors[idx >= 0 ? idx : NUM_SHAPES];
 }
 
+static const SpriteLayer spriteLayer = {
+  0, 0, BLOCK_SIZE, BLOCK_SIZE, TETRIS_COLS, TETRIS_ROWS,
+  board_color, &game, sprites, 2
+};
+
+#if SHADOW_BYTES(TETRIS_COLS, TETRIS_ROWS) <= 160
+// Lo que muestra cada celda del tablero (4 bits): draw_rows solo
+// repinta las que cambian.  El tablero denso no cabe en RAM.
+#define SHADOW
+static u_char shadowCells[SHADOW_BYTES(TETRIS_COLS, TETRIS_ROWS)];
+static const ShadowGrid shadow = {
+  0, 0, BLOCK_SIZE, BLOCK_SIZE, TETRIS_COLS, TETRIS_ROWS, shapeColors, shadowCells
+};
+#define HUD_ROWS       ((5 + 8 + BLOCK_SIZE - 1) / BLOCK_SIZE)   // filas bajo el marcador
+#endif
+
 // --------------------------------------------------
-// Dibuja todas las piezas estáticas
+// Índices de mosaico de una fila: la forma, o NUM_SHAPES (fondo)
 // --------------------------------------------------
-static void draw_grid(void) {
-  for (int c = 0; c < numColumns; c++) {
-    for (int r = 0; r < numRows; r++) {
-      signed char idx = grid[c][r];
-      if (idx >= 0) {
-        fillRectangle(c*BLOCK_SIZE,
-                      r*BLOCK_SIZE,
-                      BLOCK_SIZE, BLOCK_SIZE,
-                      shapeColors[idx]);
-      }
-    }
+static void row_tiles(const void *g, u_char r, u_char *tiles) {
+  for (int c = 0; c < TETRIS_COLS; c++) {
+    int idx = tetris_cell(g, c, r);
+    tiles[c] = idx >= 0 ? idx : NUM_SHAPES;
   }
 }
 
 // --------------------------------------------------
-// Elimina filas completas
+// Redibuja las filas fijas top..bottom (bloques y fondo).  Con la
+// sombra, solo las celdas que cambian, un rectángulo por tramo del
+// mismo color; si no, como mapa de celdas: una sola ventana, cada
+// píxel una vez.  Tapa lo que hubiera de los sprites en esas filas.
 // --------------------------------------------------
-static void clear_full_rows(void) {
-  for (int r = 0; r < numRows; r++) {
-    int full = TRUE;
-    for (int c = 0; c < numColumns; c++) {
-      if (grid[c][r] < 0) { full = FALSE; break; }
-    }
-    if (full) {
-      score += 5;
-      for (int rr = r; rr > 0; rr--)
-        for (int c = 0; c < numColumns; c++)
-          grid[c][rr] = grid[c][rr-1];
-      for (int c = 0; c < numColumns; c++)
-        grid[c][0] = -1;
-      clearScreen(BG_COLOR);
-      draw_grid();
-      draw_score_label();
-      r--;
+static void draw_rows(const Tetris *g, int top, int bottom) {
+#ifdef SHADOW
+  u_char tiles[TETRIS_COLS];
+  // bajo los sprites y el marcador la pantalla no es el tablero
+  for (int s = 0; s < 2; s++)
+    for (int i = 0; i < sprites[s].drawnCount; i++) {
+      int c = sprites[s].drawnCol[i], r = sprites[s].drawnRow[i];
+      if (r >= top && r <= bottom) shadowInvalidate(&shadow, c, r, c, r);
     }
+  if (top < HUD_ROWS)
+    shadowInvalidate(&shadow, 0, top, TETRIS_COLS - 1, bottom < HUD_ROWS ? bottom : HUD_ROWS - 1);
+  for (int r = top; r <= bottom; r++) {
+    row_tiles(g, r, tiles);
+    shadowSetRow(&shadow, r, tiles);
   }
+  shadowFlush(&shadow);
+#else
+  const TileMap map = {0, 0, BLOCK_SIZE, BLOCK_SIZE, TETRIS_COLS, TETRIS_ROWS,
+                       shapeColors, 0, row_tiles, g};
+  drawTileMap(&map, top, bottom, 0, 0);
+#endif
+  spriteForgetArea(&spriteLayer, 0, top, TETRIS_COLS - 1, bottom);
 }
 
 // --------------------------------------------------
-// Rellena y baraja la bolsa (Fisher–Yates sobre 8)
-// --------------------------------------------------
-static void refillBag(void) {
-  int idx = 0;
-  for (int m = 0; m < BAG_MULT; m++) {
-    for (int i = 0; i < NUM_SHAPES; i++) {
-      bag[idx++] = i;
-    }
-  }
-  for (int i = BAG_SIZE - 1; i > 0; i--) {
-    randState = randState * 1103515245 + 12345;
-    unsigned int j = (randState >> 16) % (i + 1);
-    unsigned char tmp = bag[i];
-    bag[i] = bag[j];
-    bag[j] = tmp;
-  }
-  bagPos = 0;
+// Tablero nuevo (o retomado): el tablero entero y lo que queda de
+// pantalla fuera de él, sin clearScreen previo; luego el puntaje
+// --------------------------------------------------
+static void draw_board(const Tetris *g) {
+#ifdef SHADOW
+  shadowInvalidate(&shadow, 0, 0, TETRIS_COLS - 1, TETRIS_ROWS - 1);
+#endif
+  draw_rows(g, 0, TETRIS_ROWS - 1);
+#if TETRIS_COLS * BLOCK_SIZE < SCREEN_WIDTH
+  fillRectangle(TETRIS_COLS * BLOCK_SIZE, 0,
+                SCREEN_WIDTH - TETRIS_COLS * BLOCK_SIZE, SCREEN_HEIGHT, BG_COLOR);
+#endif
+#if TETRIS_ROWS * BLOCK_SIZE < SCREEN_HEIGHT
+  fillRectangle(0, TETRIS_ROWS * BLOCK_SIZE,
+                TETRIS_COLS * BLOCK_SIZE, SCREEN_HEIGHT - TETRIS_ROWS * BLOCK_SIZE, BG_COLOR);
+#endif
+  draw_score_label(g);
 }
 
 // --------------------------------------------------
-// Actualiza la pieza móvil (borrado + repintado estáticos)
+// Actualiza la pieza móvil y su fantasma: la capa de sprites repinta
+// solo las celdas que cambian, a través de una lista de dibujo
+// (lcdlist) que junta los bloques vecinos del mismo color.  Sin
+// interrupciones: la gravedad y los botones dibujan filas desde sus
+// ISR, que no deben caer en la lista ni ver los sprites a medias.
 // --------------------------------------------------
+#define UPDATE_OPS 16
 static void update_moving_shape(void) {
-  if (lastIdx >= 0) {
-    // Borrar la figura anterior y restaurar fondo o bloques estáticos
-    for (int i = 0; i < 4; i++) {
-      int c = (lastCol + rotatedX(lastIdx, lastRot, i)*BLOCK_SIZE)/BLOCK_SIZE;
-      int r = (lastRow + rotatedY(lastIdx, lastRot, i)*BLOCK_SIZE)/BLOCK_SIZE;
-
-      if (c >= 0 && c < numColumns && r >= 0 && r < numRows) {
-        signed char idx = grid[c][r];
-        unsigned short color = (idx >= 0 && idx < NUM_SHAPES) ? shapeColors[idx] : BG_COLOR;
-        fillRectangle(c * BLOCK_SIZE, r * BLOCK_SIZE,
-                      BLOCK_SIZE, BLOCK_SIZE,
-                      color);
-      }
-    }
+  const PieceRot *p;
+  DlOp ops[UPDATE_OPS];
+
+  and_sr(~0x8);
+  p = &pieceTable[(int)game.shape][(int)game.rot];
+  piece.col = ghost.col = game.col;
+  piece.row = game.row;
+  ghost.row = game.dropRow;
+  piece.dx = ghost.dx = p->dx;
+  piece.dy = ghost.dy = p->dy;
+  piece.count = ghost.count = 4;
+  piece.color = ghost.color = shapeColors[(int)game.shape];
+  ghost.style = SPRITE_OUTLINE;
+
+  dlBegin(ops, UPDATE_OPS);
+  spriteUpdate(&spriteLayer);
+  dlEnd();
+  or_sr(0x8);
+}
+
+#ifdef PERSIST
+// --------------------------------------------------
+// Inserta el puntaje de la partida terminada y guarda la tabla si cambió
+// --------------------------------------------------
+static void save_high_score(int score) {
+  int i = HISCORES;
+  if (score <= hiScores[HISCORES - 1]) return;
+  while (i > 0 && hiScores[i - 1] < score) {
+    if (i < HISCORES) hiScores[i] = hiScores[i - 1];
+    i--;
   }
+  hiScores[i] = score;
+  flashStoreWrite(TAG_HISCORES, hiScores, sizeof hiScores);
+}
+#endif
+
+#ifdef SUSPEND
+// --------------------------------------------------
+// Guarda la partida y apaga todo (pantalla dormida, LPM4, sin tick);
+// una nueva pulsación reinicia el micro, que al arrancar despierta la
+// pantalla (lcd_init_start la saca del sleep) y la redibuja entera.
+// SW3 sigue apretado: se espera a que lo suelten, porque el flanco de
+// soltarlo despertaría al micro enseguida.
+// --------------------------------------------------
+static void suspend_game(void) {
+  TetrisSnapshot snap;
+  unsigned char colors[TETRIS_SNAPSHOT_COLORS];
+  and_sr(~0x8);                     // ni gravedad ni botones de aquí en más
+  WDTCTL = WDTPW | WDTHOLD;
+  // primero los colores: la instantánea, escrita al final, los valida
+  flashStoreWrite(TAG_COLORS, colors, tetris_snapshot_colors(&game, colors));
+  tetris_snapshot(&game, &snap);
+  flashStoreWrite(TAG_SNAPSHOT, &snap, sizeof snap);
+  lcd_sleep();                      // DISPOFF + SLPIN
+  suspended = TRUE;
+  P1OUT &= ~BIT6;
+  do {                              // todos sueltos, pasado el rebote
+    while ((P2IN & SWITCHES) != SWITCHES);
+    __delay_cycles(50000);
+  } while ((P2IN & SWITCHES) != SWITCHES);
+  P2IES |= SWITCHES;                // despierta solo al pulsar
+  P2IFG = 0;
+  P2IE |= SWITCHES;
+  or_sr(0xf8);                      // LPM4 + GIE
+}
 
-  // Dibujar la figura en su nueva posición
-  draw_piece(shapeCol, shapeRow, shapeIndex, shapeRotation,
-             shapeColors[shapeIndex]);
+// Retoma la partida suspendida, si están la instantánea y sus colores
+// (y los borra); si no, una nueva
+static char resume_game(void) {
+  TetrisSnapshot snap;
+  unsigned char colors[TETRIS_SNAPSHOT_COLORS];
+  int len;
+  if (flashStoreRead(TAG_SNAPSHOT, &snap, sizeof snap) != sizeof snap)
+    return FALSE;
+  len = flashStoreRead(TAG_COLORS, colors, sizeof colors);
+  flashStoreWrite(TAG_SNAPSHOT, 0, 0);
+  flashStoreWrite(TAG_COLORS, 0, 0);
+  tetris_resume(&game, &snap, 0);
+  return tetris_resume_colors(&game, colors, len);
+}
+#endif
+
+// --------------------------------------------------
+// Un paso del motor (grabado si RECORD)
+// --------------------------------------------------
+static int game_step(char input, char tick) {
+#ifdef RECORD
+  return tetris_record_step(&recorder, &game, input, tick);
+#else
+  return tetris_step(&game, input, tick);
+#endif
+}
 
-  // Guardar nueva posición como "última"
-  lastCol = shapeCol;
-  lastRow = shapeRow;
-  lastIdx = shapeIndex;
-  lastRot = shapeRotation;
+// --------------------------------------------------
+// Resultado de un paso del motor
+// --------------------------------------------------
+static void handle_events(int events) {
+  if (events & (TETRIS_LOCKED | TETRIS_NEWGAME)) {
+    pieceStoppedFlag = TRUE;
+  }
+#ifdef PERSIST
+  if (events & TETRIS_NEWGAME) gameOverDue = TRUE;
+#endif
+  if (events) redrawScreen = TRUE;
 }
 
 // --------------------------------------------------
 // Switches con debounce e interrupciones
 // --------------------------------------------------
-#define SWITCHES (BIT0 | BIT1 | BIT2 | BIT3)
 volatile int switches = 0;
 
 static char switch_update_interrupt_sense(void) {
@@ -272,128 +421,115 @@ void switch_interrupt_handler(void) {
   char p2val = switch_update_interrupt_sense();
   switches = ~p2val & SWITCHES;
 
-  if (lastIdx >= 0)
-    draw_piece(lastCol, lastRow, lastIdx, lastRot, BG_COLOR);
-
-  // SW1 izq
-  if (switches & BIT0) {
-    short newCol = shapeCol - BLOCK_SIZE;
-    int valid = TRUE;
-    for (int i = 0; i < 4; i++) {
-      int c = (newCol + rotatedX(shapeIndex, shapeRotation, i)*BLOCK_SIZE)/BLOCK_SIZE;
-      int r = (shapeRow + rotatedY(shapeIndex, shapeRotation, i)*BLOCK_SIZE)/BLOCK_SIZE;
-      if (c<0 || (r>=0 && grid[c][r]>=0)) { valid=FALSE; break; }
-    }
-    if (valid) shapeCol = newCol;
-  }
-  // SW2 rotar
-  if ((switches & BIT1) && sw2HoldCount == 0) {
-    char newRot = (shapeRotation + 1) % 4;
-    int valid = TRUE;
-    for (int i = 0; i < 4; i++) {
-      int c = (shapeCol + rotatedX(shapeIndex, newRot, i)*BLOCK_SIZE)/BLOCK_SIZE;
-      int r = (shapeRow + rotatedY(shapeIndex, newRot, i)*BLOCK_SIZE)/BLOCK_SIZE;
-      if (c<0||c>=numColumns||r>=numRows||(r>=0&&grid[c][r]>=0)) { valid=FALSE; break; }
-    }
-    if (valid) shapeRotation = newRot;
-  }
-  // SW3 reiniciar
-  if (switches & BIT2) {
-    clearScreen(BG_COLOR);
-    memset(grid, -1, sizeof grid);
-    score = 0;
-    randState = TA0R;
-    shapeRotation = 0;
-    shapeCol = ((numColumns/2)-1)*BLOCK_SIZE;
-    shapeRow = -BLOCK_SIZE*4;
-    draw_score_label();
-    sw2HoldCount = 0;
-  }
-  // SW4 der
-  if (switches & BIT3) {
-    short newCol = shapeCol + BLOCK_SIZE;
-    int valid = TRUE;
-    for (int i = 0; i < 4; i++) {
-      int c = (newCol + rotatedX(shapeIndex, shapeRotation, i)*BLOCK_SIZE)/BLOCK_SIZE;
-      int r = (shapeRow + rotatedY(shapeIndex, shapeRotation, i)*BLOCK_SIZE)/BLOCK_SIZE;
-      if (c>=numColumns || (r>=0 && grid[c][r]>=0)) { valid=FALSE; break; }
-    }
-    if (valid) shapeCol = newCol;
+#if !defined(REPLAY) && !defined(BOT)
+  // SW1..SW4 = izq, rotar, caída inmediata, der; no rotar en pulsación
+  // larga (SW2 largo es partida nueva: SW3 ya no reinicia, ver README)
+  char input = switches;
+  if (sw2HoldCount) input &= ~TETRIS_ROTATE;
+#ifdef SUSPEND
+  // SW3 largo suspende: la caída espera a que se suelte SW3, y no la
+  // hay si ya se pidió suspender
+  static char sw3Down = FALSE;
+  if (input & TETRIS_DROP) {
+    sw3Down = TRUE;
+    input &= ~TETRIS_DROP;
+  } else if (sw3Down) {
+    sw3Down = FALSE;
+    if (!suspendDue) input |= TETRIS_DROP;
   }
+#endif
+  handle_events(game_step(input, FALSE));
+#endif
 
-  redrawScreen = TRUE;
   P2IFG = 0;
   P2IE |= SWITCHES;
 }
 
 void __interrupt_vec(PORT2_VECTOR) Port_2(void) {
+#ifdef SUSPEND
+  if (suspended) WDTCTL = 0;        // clave errónea: reinicio, y se retoma
+#endif
+  ISR_ENTER(PWR_ISR_PORT2);
   if (P2IFG & SWITCHES) switch_interrupt_handler();
+  ISR_EXIT();
 }
 
 // --------------------------------------------------
-// WDT: caída, colisiones, bolsa y pulsación larga SW2
+// WDT: caída y pulsación larga SW2
 // --------------------------------------------------
-void wdt_c_handler(void) {
+#ifdef BOT
+// Paso medido: peor tiempo de fijar y de eliminar filas (incluye el
+// redibujado de las filas, que el motor pide por callback)
+static void timed_step(char input, char tick) {
+  unsigned int t0 = TA0R;
+  int events = game_step(input, tick);
+  unsigned int dt = TA0R - t0;
+  char slot = (events & TETRIS_CLEARED) ? WORST_CLEAR : WORST_LOCK;
+  if ((events & TETRIS_LOCKED) && dt > worst[(int)slot]) worst[(int)slot] = dt;
+  handle_events(events);
+}
+
+// El bot juega en cada tick del WDT; la gravedad sigue a ~4 pasos/s
+static void gravity_tick(void) {
+  static int tick = 0;
+  char fall = ++tick >= wdtTicksPerSec / 4;
+  if (fall) tick = 0;
+  timed_step(tetris_bot_input(&bot, &game), fall);
+}
+#else
+static void gravity_tick(void) {
   static int tick = 0;
-  if (++tick < 64) return;
+  if (++tick < wdtTicksPerSec / 4) return;   // ~4 pasos por segundo
   tick = 0;
 
+#ifdef REPLAY
+  // entradas y gravedad salen de la grabación, al ritmo real
+  int events = tetris_replay_tick(&replayer, &game);
+  if (events & TETRIS_ENDED) {      // repetir la sesión indefinidamente
+    tetris_replay_start(&replayer, &game, replayLog, replayLogLen, &lcdRenderer);
+    events = TETRIS_NEWGAME | TETRIS_MOVED;
+  }
+  handle_events(events);
+#else
   if (!(P2IN & BIT1)) {
     sw2HoldCount++;
     if (sw2HoldCount >= 3) {
-      clearScreen(BG_COLOR);
-      memset(grid, -1, sizeof grid);
-      score = 0;
-      randState = randState * 1103515245 + 12345;
-      shapeRotation = 0;
-      shapeCol = ((numColumns/2)-1)*BLOCK_SIZE;
-      shapeRow = -BLOCK_SIZE*4;
-      draw_score_label();
       sw2HoldCount = 0;
+      handle_events(game_step(TETRIS_RESET, FALSE));
       return;
     }
   } else {
     sw2HoldCount = 0;
   }
-
-  short newRow = shapeRow + BLOCK_SIZE;
-  int collided = FALSE;
-  for (int i = 0; i < 4; i++) {
-    int c = (shapeCol + rotatedX(shapeIndex, shapeRotation, i)*BLOCK_SIZE)/BLOCK_SIZE;
-    int r = (newRow + rotatedY(shapeIndex, shapeRotation, i)*BLOCK_SIZE)/BLOCK_SIZE;
-    if (r>=numRows || (r>=0 && grid[c][r]>=0)) { collided = TRUE; break; }
-  }
-  if (!collided) {
-    shapeRow = newRow;
-  } else {
-    if (shapeRow < 0) {
-      clearScreen(BG_COLOR);
-      memset(grid, -1, sizeof grid);
-      score = 0;
-      randState = TA0R;
-      shapeRotation = 0;
-      shapeCol = ((numColumns/2)-1)*BLOCK_SIZE;
-      shapeRow = -BLOCK_SIZE*4;
-      draw_score_label();
-      return;
+#ifdef SUSPEND
+  if (!(P2IN & BIT2)) {
+    if (++sw3HoldCount >= 3) {
+      sw3HoldCount = 0;
+      suspendDue = TRUE;
+      redrawScreen = TRUE;
     }
-    for (int i = 0; i < 4; i++) {
-      int c = (shapeCol + rotatedX(shapeIndex, shapeRotation, i)*BLOCK_SIZE)/BLOCK_SIZE;
-      int r = (shapeRow + rotatedY(shapeIndex, shapeRotation, i)*BLOCK_SIZE)/BLOCK_SIZE;
-      if (r>=0 && r<numRows) grid[c][r] = shapeIndex;
-    }
-    draw_grid();
-    clear_full_rows();
-    pieceStoppedFlag = TRUE;
-    lastIdx = -1;
+  } else {
+    sw3HoldCount = 0;
+  }
+#endif
+
+  handle_events(game_step(0, TRUE));
+#endif
+}
+#endif
 
-    if (bagPos >= BAG_SIZE) refillBag();
-    shapeIndex = bag[bagPos++];
-    shapeRotation = 0;
-    shapeCol = ((numColumns/2)-1)*BLOCK_SIZE;
-    shapeRow = -BLOCK_SIZE*4;
+void wdt_c_handler(void) {
+  ISR_ENTER(PWR_ISR_WDT);
+#if defined(POWER_STATS) || defined(BOT)
+  static int reportTick = 0;
+  if (++reportTick >= wdtTicksPerSec) {      // ~1 s
+    reportTick = 0;
+    reportDue = TRUE;
+    redrawScreen = TRUE;
   }
-  redrawScreen = TRUE;
+#endif
+  gravity_tick();
+  ISR_EXIT();
 }
 
 // --------------------------------------------------
@@ -403,30 +539,72 @@ int main(void) {
   P1DIR |= BIT6;
   P1OUT |= BIT6;
   configureClocks();
-  lcd_init();
-  clearScreen(BG_COLOR);
-  score = 0;
-  draw_score_label();
-
-  randState = TA0R;
-  refillBag();
-  shapeIndex = bag[bagPos++];
-  shapeRotation = 0;
-  shapeCol = ((numColumns/2)-1)*BLOCK_SIZE;
-  shapeRow = -BLOCK_SIZE*4;
+  lcd_init_start();          // la pantalla sale de reset mientras preparamos el juego
 
   switch_init();
-  memset(grid, -1, sizeof grid);
-
-  enableWDTInterrupts();
+#ifdef PERSIST
+  flashStoreInit();
+  flashStoreRead(TAG_HISCORES, hiScores, sizeof hiScores);
+#endif
+#if defined(REPLAY)
+  tetris_replay_start(&replayer, &game, replayLog, replayLogLen, 0);
+#elif defined(RECORD)
+  tetris_record_start(&recorder, &game, recBuf, sizeof recBuf, TA0R, 0);
+#else
+#ifdef SUSPEND
+  if (!resume_game())
+#endif
+    tetris_init(&game, TA0R, 0); // TA0 está contando los retardos del init
+#endif
+
+  lcd_init_wait();
+  game.render = &lcdRenderer;
+  draw_board(&game);         // también dibuja la partida retomada
+
+  configureACLK(ACLK_VLO);   // el tick no usa SMCLK: dormir en LPM3
+#ifdef BOT
+  tetris_bot_init(&bot);
+  TA0CTL = TASSEL_1 + MC_2 + TACLR;          // TA0 libre tras el init: cronómetro en ACLK
+#endif
+  enableWDTInterruptsACLK();
+#ifdef POWER_STATS
+  powerStatsInit();
+#endif
   or_sr(0x8);
   while (TRUE) {
     if (redrawScreen) {
       redrawScreen = FALSE;
+#ifdef BOT
+      unsigned int t0 = TA0R;
+      update_moving_shape();
+      unsigned int dt = TA0R - t0;
+      if (dt > worst[WORST_REDRAW]) worst[WORST_REDRAW] = dt;
+#else
       update_moving_shape();
+#endif
+#if defined(POWER_STATS) || defined(BOT)
+      if (reportDue) {
+        reportDue = FALSE;
+        and_sr(~0x8);               // las ISR dibujan filas: que no corten el texto
+        draw_report();
+        or_sr(0x8);
+      }
+#endif
+#ifdef PERSIST
+      if (gameOverDue) {
+        gameOverDue = FALSE;
+        and_sr(~0x8);               // ídem
+        save_high_score(game.lastScore);
+        draw_score_label(&game);
+        or_sr(0x8);
+      }
+#endif
+#ifdef SUSPEND
+      if (suspendDue) suspend_game();
+#endif
     }
     P1OUT &= ~BIT6;
-    or_sr(0x10);
+    SLEEP();
     P1OUT |= BIT6;
   }
 }
@@ -0,0 +1,66 @@
+#include "pieces.h"
+
+// --------------------------------------------------
+// Formas Tetris (4 offsets x,y cada una)
+// --------------------------------------------------
+#define SHAPE_SQUARE  0,0, 1,0, 0,1, 1,1   // cuadrado
+#define SHAPE_LINE    0,0, 1,0, 2,0, 3,0   // línea
+#define SHAPE_L       0,0, 0,1, 1,1, 2,1   // L invertida
+#define SHAPE_T       1,0, 0,1, 1,1, 2,1   // T
+
+// --------------------------------------------------
+// Rotación de 90° alrededor de (0,0), evaluada por el compilador
+// --------------------------------------------------
+#define RX(x,y,r)  ((r)==0 ? (x) : (r)==1 ? -(y) : (r)==2 ? -(x) : (y))
+#define RY(x,y,r)  ((r)==0 ? (y) : (r)==1 ? (x)  : (r)==2 ? -(y) : -(x))
+
+#define MIN2(a,b)        ((a) < (b) ? (a) : (b))
+#define MAX2(a,b)        ((a) > (b) ? (a) : (b))
+#define MIN4(a,b,c,d)    MIN2(MIN2(a,b), MIN2(c,d))
+#define MAX4(a,b,c,d)    MAX2(MAX2(a,b), MAX2(c,d))
+
+// bit de la celda (x,y) en la máscara de la fila minY+i
+#define CELL_MASK(x,y,minX,minY,i)  ((y) == (minY)+(i) ? 1 << ((x)-(minX)) : 0)
+
+#define ROW_MASK(x0,y0,x1,y1,x2,y2,x3,y3,minX,minY,i)       \
+  (CELL_MASK(x0,y0,minX,minY,i) | CELL_MASK(x1,y1,minX,minY,i) | \
+   CELL_MASK(x2,y2,minX,minY,i) | CELL_MASK(x3,y3,minX,minY,i))
+
+// dy más bajo de las celdas en la columna minX+k
+#define CELL_BOTTOM(x,y,minX,k)  ((x) == (minX)+(k) ? (y) : PIECE_NO_CELL)
+
+#define COL_BOTTOM(x0,y0,x1,y1,x2,y2,x3,y3,minX,k)                 \
+  MAX4(CELL_BOTTOM(x0,y0,minX,k), CELL_BOTTOM(x1,y1,minX,k),       \
+       CELL_BOTTOM(x2,y2,minX,k), CELL_BOTTOM(x3,y3,minX,k))
+
+#define ROTATED(x0,y0,x1,y1,x2,y2,x3,y3,minX,minY,maxX,maxY) {   \
+  {x0, x1, x2, x3}, {y0, y1, y2, y3},                           \
+  minX, maxX, minY, maxY,                                       \
+  { ROW_MASK(x0,y0,x1,y1,x2,y2,x3,y3,minX,minY,0),              \
+    ROW_MASK(x0,y0,x1,y1,x2,y2,x3,y3,minX,minY,1),              \
+    ROW_MASK(x0,y0,x1,y1,x2,y2,x3,y3,minX,minY,2),              \
+    ROW_MASK(x0,y0,x1,y1,x2,y2,x3,y3,minX,minY,3) },            \
+  { COL_BOTTOM(x0,y0,x1,y1,x2,y2,x3,y3,minX,0),                 \
+    COL_BOTTOM(x0,y0,x1,y1,x2,y2,x3,y3,minX,1),                 \
+    COL_BOTTOM(x0,y0,x1,y1,x2,y2,x3,y3,minX,2),                 \
+    COL_BOTTOM(x0,y0,x1,y1,x2,y2,x3,y3,minX,3) } }
+
+#define ROTATE(x0,y0,x1,y1,x2,y2,x3,y3,r)                       \
+  ROTATED(RX(x0,y0,r), RY(x0,y0,r), RX(x1,y1,r), RY(x1,y1,r),   \
+          RX(x2,y2,r), RY(x2,y2,r), RX(x3,y3,r), RY(x3,y3,r),   \
+          MIN4(RX(x0,y0,r), RX(x1,y1,r), RX(x2,y2,r), RX(x3,y3,r)), \
+          MIN4(RY(x0,y0,r), RY(x1,y1,r), RY(x2,y2,r), RY(x3,y3,r)), \
+          MAX4(RX(x0,y0,r), RX(x1,y1,r), RX(x2,y2,r), RX(x3,y3,r)), \
+          MAX4(RY(x0,y0,r), RY(x1,y1,r), RY(x2,y2,r), RY(x3,y3,r)))
+
+// ROTATIONS(SHAPE_x): SHAPE_x se expande a sus 8 coordenadas antes de rotar
+#define PIECE(r, ...)    ROTATE(__VA_ARGS__, r)
+#define ROTATIONS(...)   { PIECE(0, __VA_ARGS__), PIECE(1, __VA_ARGS__), \
+                           PIECE(2, __VA_ARGS__), PIECE(3, __VA_ARGS__) }
+
+const PieceRot pieceTable[NUM_SHAPES][NUM_ROTATIONS] = {
+  ROTATIONS(SHAPE_SQUARE),
+  ROTATIONS(SHAPE_LINE),
+  ROTATIONS(SHAPE_L),
+  ROTATIONS(SHAPE_T),
+};
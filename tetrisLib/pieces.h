@@ -0,0 +1,22 @@
+#ifndef pieces_included
+#define pieces_included
+
+// --------------------------------------------------
+// Tabla precalculada de cada (forma, rotación)
+// --------------------------------------------------
+#define NUM_SHAPES     4
+#define NUM_ROTATIONS  4
+
+typedef struct {
+  signed char dx[4], dy[4];   // celdas relativas al origen de la pieza
+  signed char minX, maxX;     // caja envolvente
+  signed char minY, maxY;
+  unsigned char rowMask[4];   // fila minY+i: bit k = columna minX+k
+  signed char colBottom[4];   // columna minX+k: dy de su celda más baja
+} PieceRot;
+
+#define PIECE_NO_CELL  (-128)   // colBottom de una columna sin celdas
+
+extern const PieceRot pieceTable[NUM_SHAPES][NUM_ROTATIONS];
+
+#endif // included
@@ -0,0 +1,87 @@
+#include "tetrisBot.h"
+
+// Pesos de la evaluación de una jugada
+#define W_LINES   16        // filas completadas
+#define W_HOLES   12        // celdas vacías que quedan tapadas
+#define W_HEIGHT   2        // altura de la pieza
+#define W_BUMP     1        // escalón con las columnas vecinas
+
+#define WORST     (-32767)
+#define ABS(x)    ((x) < 0 ? -(x) : (x))
+
+// --------------------------------------------------
+// Valor de dejar caer (shape, rot) en la columna col
+// --------------------------------------------------
+static int evaluate(const Tetris *g, char shape, char rot, int col) {
+  const PieceRot *p = &pieceTable[(int)shape][(int)rot];
+  int left = col + p->minX, right = col + p->maxX;
+  int land = tetris_land_row(g, shape, rot, col);
+  int top = land + p->minY;
+  int lines = 0, holes = 0, bump = 0;
+
+  if (top < 0) return WORST;            // no cabe: fin de la partida
+
+  for (int i = 0; i <= p->maxY - p->minY; i++) {
+    if ((g->rows[top + i] | ((RowBits)p->rowMask[i] << left)) == TETRIS_FULL(g))
+      lines++;
+  }
+  for (int k = 0; k <= p->maxX - p->minX; k++) {
+    if (p->colBottom[k] != PIECE_NO_CELL)
+      holes += g->colTop[left + k] - 1 - (land + p->colBottom[k]);
+  }
+  if (left > 0) bump += ABS(g->colTop[left - 1] - top);
+  if (right < TETRIS_NCOLS(g) - 1) bump += ABS(g->colTop[right + 1] - top);
+
+  return W_LINES * lines - W_HOLES * holes
+       - W_HEIGHT * (TETRIS_NROWS(g) - top) - W_BUMP * bump;
+}
+
+// Prueba todas las rotaciones y columnas de la pieza actual
+static void plan(TetrisBot *b, const Tetris *g) {
+  int best = WORST - 1;
+  b->col = g->col;
+  b->rot = g->rot;
+  for (char rot = 0; rot < NUM_ROTATIONS; rot++) {
+    const PieceRot *p = &pieceTable[(int)g->shape][(int)rot];
+    for (int col = -p->minX; col + p->maxX < TETRIS_NCOLS(g); col++) {
+      int v = evaluate(g, g->shape, rot, col);
+      if (v > best) {
+        best = v;
+        b->col = col;
+        b->rot = rot;
+      }
+    }
+  }
+}
+
+// --------------------------------------------------
+// API
+// --------------------------------------------------
+void tetris_bot_init(TetrisBot *b) {
+  b->pieces = ~0u;                      // planificar en la primera llamada
+  b->bagPos = 0;
+  b->hardDrop = 1;
+}
+
+// Entradas para este paso: rotar y desplazar hacia el destino, y
+// soltar la pieza al llegar (o si una pared u obstáculo la frena).
+// Sin hardDrop sigue intentando mientras la pieza baja (el obstáculo
+// puede quedar arriba) y, al llegar, deja que la gravedad la fije.
+char tetris_bot_input(TetrisBot *b, const Tetris *g) {
+  char input = 0;
+
+  if (g->pieces != b->pieces || g->bagPos != b->bagPos) {
+    b->pieces = g->pieces;
+    b->bagPos = g->bagPos;
+    plan(b, g);
+  } else if (b->hardDrop && g->col == b->lastCol && g->rot == b->lastRot) {
+    return TETRIS_DROP;
+  }
+  b->lastCol = g->col;
+  b->lastRot = g->rot;
+
+  if (g->rot != b->rot) input |= TETRIS_ROTATE;
+  if (g->col < b->col) input |= TETRIS_RIGHT;
+  else if (g->col > b->col) input |= TETRIS_LEFT;
+  return input || !b->hardDrop ? input : TETRIS_DROP;
+}
@@ -0,0 +1,27 @@
+#ifndef tetrisBot_included
+#define tetrisBot_included
+
+// --------------------------------------------------
+// Jugador automático.  Elige la mejor (rotación, columna) para la
+// pieza actual con el mapa de alturas del motor y devuelve las
+// entradas TETRIS_* que la llevan ahí, como si fueran los botones.
+// Sirve para pruebas de resistencia y para medir el peor caso.  Con
+// hardDrop suelta la pieza al llegar; sin él la deja bajar con la
+// gravedad, que entonces limita cuánto alcanza a moverla.
+// --------------------------------------------------
+#include "tetrisEngine.h"
+
+typedef struct {
+  unsigned int pieces;      // pieza planificada (g->pieces, g->bagPos)
+  unsigned char bagPos;
+  signed char col;          // destino
+  char rot;
+  signed char lastCol;      // posición en la llamada anterior, para
+  char lastRot;             // soltar la pieza si ya no avanza
+  char hardDrop;            // 1 (tetris_bot_init): TETRIS_DROP al llegar
+} TetrisBot;
+
+void tetris_bot_init(TetrisBot *b);
+char tetris_bot_input(TetrisBot *b, const Tetris *g);
+
+#endif // included
@@ -0,0 +1,345 @@
+#include <string.h>
+#include "tetrisEngine.h"
+
+enum { FALSE = 0, TRUE = 1 };
+
+#define COLOR_WORD(c)   ((c) >> 3)
+#define COLOR_SHIFT(c)  (((c) & 7) << 1)
+
+// --------------------------------------------------
+// Acceso a la rejilla
+// --------------------------------------------------
+int tetris_cell(const Tetris *g, int c, int r) {
+  if (!(g->rows[r] & ((RowBits)1 << c)))
+    return -1;
+#if TETRIS_COLORS
+  return (g->colors[r][COLOR_WORD(c)] >> COLOR_SHIFT(c)) & 3;
+#else
+  return 0;
+#endif
+}
+
+static void set_cell(Tetris *g, int c, int r, char shape) {
+  g->rows[r] |= (RowBits)1 << c;
+#if TETRIS_COLORS
+  unsigned short *w = &g->colors[r][COLOR_WORD(c)];
+  *w = (*w & ~(3u << COLOR_SHIFT(c))) | ((unsigned short)shape << COLOR_SHIFT(c));
+#endif
+}
+
+// --------------------------------------------------
+// ¿Cabe la pieza en (col,row)?  Caja envolvente contra paredes y
+// fondo, luego una máscara AND por fila contra el bitboard.
+// --------------------------------------------------
+int tetris_fits(const Tetris *g, char shape, char rot, int col, int row) {
+  const PieceRot *p = &pieceTable[(int)shape][(int)rot];
+  int left = col + p->minX;
+  if (left < 0 || col + p->maxX >= TETRIS_NCOLS(g) || row + p->maxY >= TETRIS_NROWS(g))
+    return FALSE;
+  for (int i = 0, r = row + p->minY; r <= row + p->maxY; i++, r++) {
+    if (r >= 0 && (g->rows[r] & ((RowBits)p->rowMask[i] << left)))
+      return FALSE;
+  }
+  return TRUE;
+}
+
+// --------------------------------------------------
+// Mapa de alturas: colTop[c] es la fila ocupada más alta de la
+// columna c.  Al fijar basta un mínimo; tras eliminar filas se
+// recalcula de arriba hacia abajo hasta haber visto todas las columnas.
+// --------------------------------------------------
+static void update_col_tops(Tetris *g) {
+  RowBits seen = 0;
+  memset(g->colTop, TETRIS_NROWS(g), sizeof g->colTop);
+  for (int r = 0; r < TETRIS_NROWS(g) && seen != TETRIS_FULL(g); r++) {
+    RowBits fresh = g->rows[r] & ~seen;
+    seen |= fresh;
+    for (int c = 0; fresh; c++, fresh >>= 1) {
+      if (fresh & 1) g->colTop[c] = r;
+    }
+  }
+}
+
+// Fila donde se apoyaría la pieza dejada caer desde arriba del todo en
+// la columna col: cuatro consultas al mapa de alturas.
+int tetris_land_row(const Tetris *g, char shape, char rot, int col) {
+  const PieceRot *p = &pieceTable[(int)shape][(int)rot];
+  int land = TETRIS_NROWS(g) - 1 - p->maxY;
+  for (int k = 0; k <= p->maxX - p->minX; k++) {
+    if (p->colBottom[k] == PIECE_NO_CELL) continue;
+    int r = g->colTop[col + p->minX + k] - 1 - p->colBottom[k];
+    if (r < land) land = r;
+  }
+  return land;
+}
+
+// Fila de aterrizaje de la pieza móvil.  Si alguna celda ya está por
+// debajo de la superficie de su columna (la pieza entró bajo un alero)
+// se sondea fila a fila.
+static void update_drop_row(Tetris *g) {
+  int land = tetris_land_row(g, g->shape, g->rot, g->col);
+  if (land < g->row) {
+    land = g->row;
+    while (tetris_fits(g, g->shape, g->rot, g->col, land + 1)) land++;
+  }
+  g->dropRow = land;
+}
+
+// --------------------------------------------------
+// Rellena y baraja la bolsa (Fisher–Yates)
+// --------------------------------------------------
+static void refill_bag(Tetris *g) {
+  int idx = 0;
+  while (idx < TETRIS_NBAG(g)) {
+    for (int i = 0; i < NUM_SHAPES; i++) {
+      g->bag[idx++] = i;
+    }
+  }
+  for (int i = TETRIS_NBAG(g) - 1; i > 0; i--) {
+    // 32 bits tanto en msp430 como en un host de 64: mismas secuencias
+    g->randState = (g->randState * 1103515245 + 12345) & 0xffffffffUL;
+    unsigned int j = (unsigned int)((g->randState >> 16) & 0xffff) % (i + 1);
+    unsigned char tmp = g->bag[i];
+    g->bag[i] = g->bag[j];
+    g->bag[j] = tmp;
+  }
+  g->bagPos = 0;
+}
+
+static void spawn(Tetris *g) {
+  if (g->bagPos >= TETRIS_NBAG(g)) refill_bag(g);
+  g->shape = g->bag[g->bagPos++];
+  g->rot = 0;
+  g->col = TETRIS_NCOLS(g) / 2 - 1;
+  g->row = TETRIS_SPAWN_ROW;
+  update_drop_row(g);
+}
+
+// --------------------------------------------------
+// Filas completas entre top y bottom: solo las de la pieza recién
+// fijada pueden llenarse.  Devuelve el conjunto, bit i = fila top+i.
+// --------------------------------------------------
+static unsigned char full_rows(const Tetris *g, int top, int bottom) {
+  unsigned char full = 0;
+  for (int r = top; r <= bottom; r++) {
+    if (g->rows[r] == TETRIS_FULL(g)) full |= 1 << (r - top);
+  }
+  return full;
+}
+
+// --------------------------------------------------
+// Elimina las filas del conjunto cleared en una pasada de abajo hacia
+// arriba, moviendo cada fila superviviente una sola vez, hasta
+// stackTop (más arriba todo está vacío).
+// --------------------------------------------------
+static void collapse_rows(Tetris *g, int top, int bottom,
+                          unsigned char cleared, int stackTop) {
+  int dst = bottom;
+  for (int src = bottom; src >= stackTop; src--) {
+    if (src >= top && (cleared & (1 << (src - top))))
+      continue;
+    if (dst != src) {
+      g->rows[dst] = g->rows[src];
+#if TETRIS_COLORS
+      memcpy(g->colors[dst], g->colors[src], sizeof g->colors[0]);
+#endif
+    }
+    dst--;
+  }
+  for (; dst >= stackTop; dst--) {
+    g->rows[dst] = 0;
+#if TETRIS_COLORS
+    memset(g->colors[dst], 0, sizeof g->colors[0]);
+#endif
+  }
+}
+
+// --------------------------------------------------
+// Fija la pieza, limpia filas y saca la siguiente de la bolsa
+// --------------------------------------------------
+static int lock_piece(Tetris *g) {
+  const PieceRot *p = &pieceTable[(int)g->shape][(int)g->rot];
+  const TetrisRenderer *render = g->render;
+  int top = g->row + p->minY, bottom = g->row + p->maxY;
+  int events = TETRIS_LOCKED | TETRIS_MOVED;
+
+  if (top < 0) {                        // no cabe: game over
+    tetris_new_game(g);
+    return TETRIS_NEWGAME | TETRIS_MOVED;
+  }
+  for (int i = 0; i < 4; i++) {
+    int c = g->col + p->dx[i], r = g->row + p->dy[i];
+    set_cell(g, c, r, g->shape);
+    if (r < g->colTop[c]) g->colTop[c] = r;
+  }
+  g->pieces++;
+
+  unsigned char cleared = full_rows(g, top, bottom);
+  if (cleared) {
+    int stackTop = top;
+    for (int c = 0; c < TETRIS_NCOLS(g); c++) {
+      if (g->colTop[c] < stackTop) stackTop = g->colTop[c];
+    }
+    collapse_rows(g, top, bottom, cleared, stackTop);
+    update_col_tops(g);
+    int n = 0;
+    for (; cleared; cleared &= cleared - 1) n++;
+    g->score += TETRIS_SCORE(g, n);
+    g->lines += n;
+    top = stackTop;                     // bajó todo desde la cima de la pila
+    events |= TETRIS_CLEARED;
+  }
+  if (render && render->rows) render->rows(g, top, bottom);
+  if ((events & TETRIS_CLEARED) && render && render->score) render->score(g);
+
+  spawn(g);
+  return events;
+}
+
+// --------------------------------------------------
+// API
+// --------------------------------------------------
+void tetris_new_game(Tetris *g) {
+  g->lastScore = g->score;
+  memset(g->rows, 0, sizeof g->rows);
+#if TETRIS_COLORS
+  memset(g->colors, 0, sizeof g->colors);
+#endif
+  memset(g->colTop, TETRIS_NROWS(g), sizeof g->colTop);
+  g->score = 0;
+  g->lines = 0;
+  g->pieces = 0;
+  spawn(g);
+  if (g->render && g->render->board) g->render->board(g);
+}
+
+void tetris_init(Tetris *g, unsigned long seed, const TetrisRenderer *render) {
+  g->score = 0;
+  g->randState = seed & 0xffffffffUL;
+  g->bagPos = TETRIS_NBAG(g);           // fuerza refill inicial
+  g->render = render;
+  tetris_new_game(g);
+}
+
+// --------------------------------------------------
+// Suspender y reanudar
+// --------------------------------------------------
+void tetris_snapshot(const Tetris *g, TetrisSnapshot *s) {
+  memcpy(s->rows, g->rows, sizeof s->rows);
+  s->randState = g->randState;
+  s->score = g->score;
+  s->lines = g->lines;
+  memset(s->bag, 0, sizeof s->bag);
+  for (int i = 0; i < TETRIS_NBAG(g); i++)
+    s->bag[i >> 2] |= g->bag[i] << ((i & 3) << 1);
+  s->bagPos = g->bagPos;
+  s->shape = g->shape;
+}
+
+void tetris_resume(Tetris *g, const TetrisSnapshot *s, const TetrisRenderer *render) {
+  memcpy(g->rows, s->rows, sizeof g->rows);
+#if TETRIS_COLORS
+  memset(g->colors, 0, sizeof g->colors);
+#endif
+  update_col_tops(g);
+  g->randState = s->randState;
+  g->score = s->score;
+  g->lastScore = 0;
+  g->lines = s->lines;
+  g->pieces = 0;
+  for (int i = 0; i < TETRIS_NBAG(g); i++)
+    g->bag[i] = (s->bag[i >> 2] >> ((i & 3) << 1)) & 3;
+  g->bagPos = s->bagPos;
+  g->shape = s->shape;
+  g->rot = 0;
+  g->col = TETRIS_NCOLS(g) / 2 - 1;
+  g->row = TETRIS_SPAWN_ROW;
+  update_drop_row(g);
+  g->render = render;
+  if (render && render->board) render->board(g);
+  if (render && render->rows) render->rows(g, 0, TETRIS_NROWS(g) - 1);
+}
+
+// Colores de los bloques fijos, de la fila de abajo hacia arriba; sin
+// plano de color no hay nada que guardar
+int tetris_snapshot_colors(const Tetris *g, unsigned char *buf) {
+  int n = 0;
+#if TETRIS_COLORS
+  for (int r = TETRIS_NROWS(g) - 1; r >= 0; r--)
+    for (int c = 0; c < TETRIS_NCOLS(g); c++) {
+      int shape = tetris_cell(g, c, r);
+      if (shape < 0) continue;
+      if (n == 4 * TETRIS_SNAPSHOT_COLORS) return TETRIS_SNAPSHOT_COLORS;
+      if (!(n & 3)) buf[n >> 2] = 0;
+      buf[n >> 2] |= shape << ((n & 3) << 1);
+      n++;
+    }
+#endif
+  return (n + 3) / 4;
+}
+
+// Devuelve los colores a un tablero retomado con tetris_resume, antes de
+// dibujarlo.  len debe ser lo que tetris_snapshot_colors guardó para este
+// tablero; si no (el registro se perdió o es de otra partida), FALSE y
+// no se toca nada.
+int tetris_resume_colors(Tetris *g, const unsigned char *buf, int len) {
+  int n = 0;
+#if TETRIS_COLORS
+  for (int r = 0; r < TETRIS_NROWS(g); r++)
+    for (RowBits bits = g->rows[r]; bits; bits &= bits - 1)
+      n++;
+  if (n > 4 * TETRIS_SNAPSHOT_COLORS) n = 4 * TETRIS_SNAPSHOT_COLORS;
+  if (len != (n + 3) / 4) return FALSE;
+  n = 0;
+  for (int r = TETRIS_NROWS(g) - 1; r >= 0 && n < 4 * len; r--)
+    for (int c = 0; c < TETRIS_NCOLS(g) && n < 4 * len; c++)
+      if (tetris_cell(g, c, r) >= 0) {
+        set_cell(g, c, r, (buf[n >> 2] >> ((n & 3) << 1)) & 3);
+        n++;
+      }
+#endif
+  return len == (n + 3) / 4;
+}
+
+// Un paso del juego: aplica las entradas (en el orden SW1, SW2, SW3,
+// SW4 y reinicio) y, si tick, la gravedad.  Devuelve los TETRIS_*
+// ocurridos.  dropRow se mantiene al día, así que la gravedad y la
+// caída inmediata no sondean colisiones.
+int tetris_step(Tetris *g, char input, char tick) {
+  int events = 0;
+
+  if ((input & TETRIS_LEFT) && tetris_fits(g, g->shape, g->rot, g->col - 1, g->row)) {
+    g->col--;
+    events |= TETRIS_MOVED;
+  }
+  if (input & TETRIS_ROTATE) {
+    char newRot = (g->rot + 1) % NUM_ROTATIONS;
+    if (tetris_fits(g, g->shape, newRot, g->col, g->row)) {
+      g->rot = newRot;
+      events |= TETRIS_MOVED;
+    }
+  }
+  if (events) update_drop_row(g);
+  if (input & TETRIS_DROP) {
+    g->row = g->dropRow;
+    events |= lock_piece(g) | TETRIS_DROPPED;
+  }
+  if ((input & TETRIS_RIGHT) && tetris_fits(g, g->shape, g->rot, g->col + 1, g->row)) {
+    g->col++;
+    update_drop_row(g);
+    events |= TETRIS_MOVED;
+  }
+  if (input & TETRIS_RESET) {
+    tetris_new_game(g);
+    events |= TETRIS_NEWGAME | TETRIS_MOVED;
+  }
+  if (tick) {
+    if (g->row < g->dropRow) {
+      g->row++;
+      events |= TETRIS_MOVED;
+    } else {
+      events |= lock_piece(g);
+    }
+  }
+  return events;
+}
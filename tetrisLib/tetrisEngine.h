@@ -0,0 +1,147 @@
+#ifndef tetrisEngine_included
+#define tetrisEngine_included
+
+// --------------------------------------------------
+// Motor de Tetris sin hardware: estado del juego, colisiones, filas y
+// puntaje.  No toca registros ni la pantalla; compila igual para
+// msp430g2553 que para Linux.  El dibujo se hace por callbacks.
+// --------------------------------------------------
+#include "pieces.h"
+
+// Geometría del tablero (en celdas); fija en tiempo de compilación
+#ifndef TETRIS_COLS
+#define TETRIS_COLS   16
+#endif
+#ifndef TETRIS_ROWS
+#define TETRIS_ROWS   20
+#endif
+
+// Bolsa con BAG_MULT copias de cada forma
+#ifndef TETRIS_BAG_MULT
+#define TETRIS_BAG_MULT  2
+#endif
+#define TETRIS_BAG_SIZE  (NUM_SHAPES * TETRIS_BAG_MULT)
+
+// Una palabra de ocupación por fila (bit c = columna c)
+#if TETRIS_COLS > 16
+typedef unsigned long RowBits;
+#else
+typedef unsigned int RowBits;
+#endif
+
+// Fila llena: los TETRIS_COLS bits bajos (sin desbordar el desplazamiento)
+#define TETRIS_FULL_ROW  ((RowBits)((((RowBits)1 << (TETRIS_COLS - 1)) << 1) - 1))
+
+// Plano de color: 2 bits por celda, 8 celdas por palabra.  En tableros
+// densos (32x40 con bloques de 4 px) no cabe en los 512 bytes de RAM:
+// solo queda el bitboard y los bloques fijos son de un único color.
+#ifndef TETRIS_COLORS
+#define TETRIS_COLORS  (TETRIS_COLS * TETRIS_ROWS <= 512)
+#endif
+#define TETRIS_COLOR_WORDS  ((TETRIS_COLS + 7) / 8)
+
+// Configuración en tiempo de ejecución, solo con TETRIS_CONFIG (para
+// los barridos en Linux; el msp430 no paga nada): tablero, bolsa y
+// puntaje de cada partida.  TETRIS_COLS, TETRIS_ROWS y TETRIS_BAG_MULT
+// pasan a ser los máximos.  g->config se asigna antes de tetris_init.
+typedef struct {
+  unsigned char cols, rows;     // hasta TETRIS_COLS x TETRIS_ROWS
+  unsigned char bagMult;        // hasta TETRIS_BAG_MULT
+  int lineScore[4];             // puntos de una fijada que elimina 1..4 filas
+} TetrisConfig;
+
+#define TETRIS_LINE_SCORE  5    // sin TETRIS_CONFIG: por fila eliminada
+
+#ifdef TETRIS_CONFIG
+#define TETRIS_NCOLS(g)      ((g)->config->cols)
+#define TETRIS_NROWS(g)      ((g)->config->rows)
+#define TETRIS_NBAG(g)       (NUM_SHAPES * (g)->config->bagMult)
+#define TETRIS_FULL(g)       ((RowBits)((((RowBits)1 << (TETRIS_NCOLS(g) - 1)) << 1) - 1))
+#define TETRIS_SCORE(g, n)   ((g)->config->lineScore[(n) - 1])
+#else
+#define TETRIS_NCOLS(g)      TETRIS_COLS
+#define TETRIS_NROWS(g)      TETRIS_ROWS
+#define TETRIS_NBAG(g)       TETRIS_BAG_SIZE
+#define TETRIS_FULL(g)       TETRIS_FULL_ROW
+#define TETRIS_SCORE(g, n)   (TETRIS_LINE_SCORE * (n))
+#endif
+
+// Entradas de tetris_step (las cuatro primeras coinciden con SW1..SW4 en P2)
+#define TETRIS_LEFT     1
+#define TETRIS_ROTATE   2
+#define TETRIS_DROP     4     // caída inmediata hasta dropRow
+#define TETRIS_RIGHT    8
+#define TETRIS_RESET    16
+
+// Eventos devueltos por tetris_step
+#define TETRIS_MOVED    1     // la pieza móvil cambió de lugar o forma
+#define TETRIS_LOCKED   2     // la pieza se fijó en el tablero
+#define TETRIS_CLEARED  4     // se eliminaron filas
+#define TETRIS_NEWGAME  8     // tablero vacío (reinicio o game over)
+#define TETRIS_DROPPED  16    // la pieza cayó de golpe (la anterior no se dibujó abajo)
+
+struct Tetris;
+
+// Callbacks de dibujo; cualquiera puede ser NULL (modo sin pantalla)
+typedef struct {
+  void (*board)(const struct Tetris *g);                   // redibujar todo
+  void (*rows)(const struct Tetris *g, int top, int bottom); // filas fijas cambiadas
+  void (*score)(const struct Tetris *g);                   // el puntaje cambió
+} TetrisRenderer;
+
+typedef struct Tetris {
+  RowBits rows[TETRIS_ROWS];
+#if TETRIS_COLORS
+  unsigned short colors[TETRIS_ROWS][TETRIS_COLOR_WORDS];
+#endif
+  signed char colTop[TETRIS_COLS];  // fila más alta ocupada (TETRIS_ROWS: vacía)
+  signed char col, row;         // origen de la pieza móvil, en celdas
+  signed char dropRow;          // fila donde se fijaría la pieza (fantasma)
+  char shape, rot;
+  unsigned char bag[TETRIS_BAG_SIZE];
+  unsigned char bagPos;
+  unsigned long randState;      // LCG
+  int score;
+  int lastScore;                // puntaje final de la partida anterior
+  unsigned int lines;           // filas eliminadas en esta partida
+  unsigned int pieces;          // piezas fijadas en esta partida
+  const TetrisRenderer *render;
+#ifdef TETRIS_CONFIG
+  const TetrisConfig *config;
+#endif
+} Tetris;
+
+#define TETRIS_SPAWN_COL  ((TETRIS_COLS / 2) - 1)
+#define TETRIS_SPAWN_ROW  (-4)
+
+// Partida suspendida: lo mínimo para seguirla; la pieza actual vuelve
+// a salir desde arriba.  52 bytes en 16x20.  Los colores van aparte.
+typedef struct {
+  RowBits rows[TETRIS_ROWS];
+  unsigned long randState;
+  int score;
+  unsigned int lines;
+  unsigned char bag[(TETRIS_BAG_SIZE + 3) / 4];   // 2 bits por forma
+  unsigned char bagPos;
+  char shape;
+} TetrisSnapshot;
+
+// Colores de los bloques fijos de una partida suspendida, 2 bits por
+// bloque desde la fila de abajo: un segundo registro, porque con la
+// instantánea no caben en uno de flashLib.  Decisión: con más de
+// 4 * TETRIS_SNAPSHOT_COLORS bloques (176, más de medio tablero de
+// 16x20), los de más arriba vuelven con el color de la forma 0.
+#define TETRIS_SNAPSHOT_COLORS  44
+
+void tetris_init(Tetris *g, unsigned long seed, const TetrisRenderer *render);
+void tetris_new_game(Tetris *g);
+int  tetris_step(Tetris *g, char input, char tick);
+int  tetris_fits(const Tetris *g, char shape, char rot, int col, int row);
+int  tetris_cell(const Tetris *g, int col, int row);   // forma (0 sin TETRIS_COLORS) o -1
+int  tetris_land_row(const Tetris *g, char shape, char rot, int col);
+void tetris_snapshot(const Tetris *g, TetrisSnapshot *s);
+void tetris_resume(Tetris *g, const TetrisSnapshot *s, const TetrisRenderer *render);
+int  tetris_snapshot_colors(const Tetris *g, unsigned char *buf);      // bytes usados
+int  tetris_resume_colors(Tetris *g, const unsigned char *buf, int len); // FALSE: no son de este tablero
+
+#endif // included
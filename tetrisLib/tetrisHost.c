@@ -0,0 +1,176 @@
+// --------------------------------------------------
+// Simulación sin pantalla del motor en Linux.
+//
+//   ./tetrisHost [-n ticks] [-s seed] [-w rec.bin] [-c rec.c]
+//       juega con entradas pseudoaleatorias y mide ticks por segundo;
+//       -w/-c guardan la partida (binario / arreglo C para REPLAY=)
+//   ./tetrisHost -r rec.bin [-x veces]
+//       reproduce una grabación (p. ej. volcada del dispositivo) a
+//       máxima velocidad, tantas veces como se pida
+//   ./tetrisHost -b partidas [-s seed] [-m piezas]
+//       el jugador automático juega partidas (de a lo sumo -m piezas)
+//       y se informa el peor tiempo de fijar / eliminar filas
+// --------------------------------------------------
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+#include <unistd.h>
+#include "tetrisEngine.h"
+#include "tetrisReplay.h"
+#include "tetrisBot.h"
+
+#define MAX_RECORDING  (1u << 16)
+#define BOT_GRAVITY    4        // pasos del bot por tick de gravedad
+
+static unsigned char recording[MAX_RECORDING];
+
+static void report(const char *what, unsigned long ticks, clock_t start) {
+  double secs = (double)(clock() - start) / CLOCKS_PER_SEC;
+  printf("%s: %lu ticks  %.3f s  %.0f ticks/s\n",
+         what, ticks, secs, secs > 0 ? ticks / secs : 0.0);
+}
+
+static void write_c(const char *path, const unsigned char *buf, unsigned int len) {
+  FILE *f = fopen(path, "w");
+  if (!f) { perror(path); exit(1); }
+  fprintf(f, "// grabación generada por tetrisHost\n");
+  fprintf(f, "const unsigned char replayLog[] = {");
+  for (unsigned int i = 0; i < len; i++)
+    fprintf(f, "%s0x%02x,", i % 12 ? " " : "\n  ", buf[i]);
+  fprintf(f, "\n};\nconst unsigned int replayLogLen = sizeof replayLog;\n");
+  fclose(f);
+}
+
+// partida con entradas pseudoaleatorias, grabada
+static unsigned int play_random(unsigned long ticks, unsigned long seed) {
+  unsigned long inputState = seed ^ 0x5a5a5a5aUL;
+  unsigned long games = 1, pieces = 0, lines = 0;
+  TetrisRecorder rec;
+  Tetris game;
+
+  tetris_record_start(&rec, &game, recording, sizeof recording, seed, NULL);
+  clock_t start = clock();
+  for (unsigned long t = 0; t < ticks; t++) {
+    inputState = inputState * 1103515245 + 12345;
+    char input = (inputState >> 16) & (TETRIS_LEFT | TETRIS_ROTATE | TETRIS_RIGHT);
+    if (!((inputState >> 24) & 31)) input |= TETRIS_DROP;
+    unsigned int p = game.pieces, l = game.lines;
+    int ev = tetris_record_step(&rec, &game, input, 1);
+    if (ev & TETRIS_NEWGAME) {
+      games++;
+    } else {
+      pieces += game.pieces - p;
+      lines += game.lines - l;
+    }
+  }
+  report("play", ticks, start);
+  printf("games %lu  pieces %lu  lines %lu%s\n",
+         games, pieces, lines, rec.full ? "  (grabación truncada)" : "");
+  printf("score %d  lines %u  pieces %u\n", game.score, game.lines, game.pieces);
+  return tetris_record_end(&rec);
+}
+
+static void replay(const unsigned char *buf, unsigned int len, unsigned int repeat) {
+  unsigned long ticks = 0;
+  TetrisReplay rp;
+  Tetris game;
+
+  clock_t start = clock();
+  for (unsigned int i = 0; i < repeat; i++) {
+    tetris_replay_start(&rp, &game, buf, len, NULL);
+    while (!(tetris_replay_tick(&rp, &game) & TETRIS_ENDED))
+      ticks++;
+  }
+  report("replay", ticks, start);
+  printf("score %d  lines %u  pieces %u\n", game.score, game.lines, game.pieces);
+}
+
+static long elapsed_ns(const struct timespec *a, const struct timespec *b) {
+  return (b->tv_sec - a->tv_sec) * 1000000000L + (b->tv_nsec - a->tv_nsec);
+}
+
+// partidas del jugador automático, sin pantalla
+static void play_bot(unsigned long games, unsigned long seed, unsigned int maxPieces) {
+  unsigned long done = 0, steps = 0, lines = 0, pieces = 0;
+  long worstLock = 0, worstClear = 0;
+  struct timespec t0, t1;
+  TetrisBot bot;
+  Tetris game;
+
+  tetris_init(&game, seed, NULL);
+  tetris_bot_init(&bot);
+  clock_t start = clock();
+  while (done < games) {
+    char input = tetris_bot_input(&bot, &game);
+    unsigned int l = game.lines, p = game.pieces;
+    if (p >= maxPieces) input = TETRIS_RESET;
+
+    clock_gettime(CLOCK_MONOTONIC, &t0);
+    int ev = tetris_step(&game, input, steps++ % BOT_GRAVITY == 0);
+    clock_gettime(CLOCK_MONOTONIC, &t1);
+
+    long ns = elapsed_ns(&t0, &t1);
+    if ((ev & TETRIS_CLEARED) && ns > worstClear) worstClear = ns;
+    else if ((ev & TETRIS_LOCKED) && ns > worstLock) worstLock = ns;
+    if (ev & TETRIS_NEWGAME) {
+      done++;
+      lines += l;
+      pieces += p;
+    }
+  }
+  double secs = (double)(clock() - start) / CLOCKS_PER_SEC;
+  printf("bot: %lu games  %.3f s  %.0f games/s\n",
+         done, secs, secs > 0 ? done / secs : 0.0);
+  printf("per game: lines %.1f  pieces %.1f\n",
+         (double)lines / done, (double)pieces / done);
+  printf("worst step: lock %ld ns  clear %ld ns\n", worstLock, worstClear);
+}
+
+int main(int argc, char **argv) {
+  unsigned long ticks = 10000000UL, seed = 1, botGames = 0;
+  unsigned int repeat = 1, maxPieces = 200;
+  const char *in = 0, *out = 0, *outC = 0;
+  int opt;
+
+  while ((opt = getopt(argc, argv, "n:s:r:w:c:x:b:m:")) != -1) {
+    switch (opt) {
+    case 'n': ticks = strtoul(optarg, 0, 0); break;
+    case 's': seed = strtoul(optarg, 0, 0); break;
+    case 'r': in = optarg; break;
+    case 'w': out = optarg; break;
+    case 'c': outC = optarg; break;
+    case 'x': repeat = strtoul(optarg, 0, 0); break;
+    case 'b': botGames = strtoul(optarg, 0, 0); break;
+    case 'm': maxPieces = strtoul(optarg, 0, 0); break;
+    default:
+      fprintf(stderr, "uso: %s [-n ticks] [-s seed] [-w rec.bin] [-c rec.c] | -r rec.bin [-x veces]"
+              " | -b partidas [-m piezas]\n", argv[0]);
+      return 2;
+    }
+  }
+
+  if (botGames) {
+    play_bot(botGames, seed, maxPieces);
+    return 0;
+  }
+
+  if (in) {
+    FILE *f = fopen(in, "rb");
+    if (!f) { perror(in); return 1; }
+    unsigned int len = fread(recording, 1, sizeof recording, f);
+    fclose(f);
+    replay(recording, len, repeat);
+    return 0;
+  }
+
+  unsigned int len = play_random(ticks, seed);
+  if (out) {
+    FILE *f = fopen(out, "wb");
+    if (!f) { perror(out); return 1; }
+    fwrite(recording, 1, len, f);
+    fclose(f);
+  }
+  if (outC) write_c(outC, recording, len);
+  replay(recording, len, 1);      // comprobación: misma partida
+  return 0;
+}
@@ -0,0 +1,104 @@
+#include "tetrisReplay.h"
+
+// --------------------------------------------------
+// Grabación
+// --------------------------------------------------
+// el búfer queda siempre terminado: se puede volcar en cualquier momento
+static void put(TetrisRecorder *r, unsigned char b) {
+  if (r->len < r->size - 1) {       // siempre queda lugar para el fin
+    r->buf[r->len++] = b;
+    r->buf[r->len] = 0;
+  } else {
+    r->full = 1;
+  }
+}
+
+#define MAX_TICKS   ((1 << (8 - TETRIS_REPLAY_SHIFT)) - 1)
+#define INPUT_MASK  ((1 << TETRIS_REPLAY_SHIFT) - 1)
+
+// vuelca los ticks pendientes de a MAX_TICKS y deja el resto
+static void flush_ticks(TetrisRecorder *r) {
+  while (r->ticks >= MAX_TICKS) {
+    put(r, MAX_TICKS << TETRIS_REPLAY_SHIFT);
+    r->ticks -= MAX_TICKS;
+  }
+}
+
+void tetris_record_start(TetrisRecorder *r, Tetris *g, unsigned char *buf,
+                         unsigned int size, unsigned long seed,
+                         const TetrisRenderer *render) {
+  r->buf = buf;
+  r->size = size;
+  r->len = 0;
+  r->ticks = 0;
+  r->full = 0;
+  for (int i = 0; i < TETRIS_REPLAY_HEADER; i++)
+    put(r, seed >> (8 * i));
+  tetris_init(g, seed, render);
+}
+
+// tetris_step, anotando la entrada
+int tetris_record_step(TetrisRecorder *r, Tetris *g, char input, char tick) {
+  input &= INPUT_MASK;
+  if (input && !r->full) {
+    flush_ticks(r);
+    put(r, (r->ticks << TETRIS_REPLAY_SHIFT) | input);
+    r->ticks = 0;
+  }
+  if (tick) r->ticks++;
+  return tetris_step(g, input, tick);
+}
+
+// cierra la grabación; devuelve su largo en bytes
+unsigned int tetris_record_end(TetrisRecorder *r) {
+  if (!r->full) {
+    flush_ticks(r);
+    if (r->ticks) put(r, r->ticks << TETRIS_REPLAY_SHIFT);
+    r->ticks = 0;
+  }
+  r->buf[r->len++] = 0;
+  return r->len;
+}
+
+// --------------------------------------------------
+// Reproducción
+// --------------------------------------------------
+static void next_input(TetrisReplay *p) {
+  p->input = 0;
+  while (p->pos < p->end) {
+    unsigned char b = *p->pos++;
+    if (!b) break;                  // fin
+    p->wait += b >> TETRIS_REPLAY_SHIFT;
+    if (b & INPUT_MASK) {
+      p->input = b & INPUT_MASK;
+      return;
+    }
+  }
+  p->pos = p->end;
+}
+
+void tetris_replay_start(TetrisReplay *p, Tetris *g, const unsigned char *buf,
+                         unsigned int len, const TetrisRenderer *render) {
+  unsigned long seed = 0;
+  for (int i = TETRIS_REPLAY_HEADER - 1; i >= 0; i--)
+    seed = (seed << 8) | buf[i];
+  p->pos = buf + TETRIS_REPLAY_HEADER;
+  p->end = buf + len;
+  p->wait = 0;
+  next_input(p);
+  tetris_init(g, seed, render);
+}
+
+// Un tick de gravedad: primero las entradas que tocaban antes de él.
+// Devuelve los eventos del motor, o TETRIS_ENDED al agotarse.
+int tetris_replay_tick(TetrisReplay *p, Tetris *g) {
+  int events = 0;
+  while (p->input && !p->wait) {
+    events |= tetris_step(g, p->input, 0);
+    next_input(p);
+  }
+  if (!p->wait)
+    return events | TETRIS_ENDED;
+  p->wait--;
+  return events | tetris_step(g, 0, 1);
+}
@@ -0,0 +1,42 @@
+#ifndef tetrisReplay_included
+#define tetrisReplay_included
+
+// --------------------------------------------------
+// Grabación y reproducción determinista de partidas.
+//
+// Formato: 4 bytes de semilla (LSB primero) y luego un byte por entrada:
+//   (ticks de gravedad desde la anterior << 5) | entrada (TETRIS_LEFT..RESET)
+// Un byte con entrada 0 solo avanza 1..7 ticks; 0x00 marca el fin.
+// Como el motor es determinista, semilla + entradas reproducen la
+// partida exacta, en el dispositivo o en Linux.
+// --------------------------------------------------
+#include "tetrisEngine.h"
+
+#define TETRIS_REPLAY_HEADER  4
+#define TETRIS_REPLAY_SHIFT   5     // ticks en los 3 bits altos
+#define TETRIS_ENDED          32    // evento: la grabación se terminó
+
+typedef struct {
+  unsigned char *buf;
+  unsigned int size, len;
+  unsigned int ticks;       // ticks desde la última entrada grabada
+  char full;                // sin espacio: se dejó de grabar
+} TetrisRecorder;
+
+typedef struct {
+  const unsigned char *pos, *end;
+  unsigned int wait;        // ticks hasta la próxima entrada
+  char input;               // próxima entrada (0: no quedan)
+} TetrisReplay;
+
+void tetris_record_start(TetrisRecorder *r, Tetris *g, unsigned char *buf,
+                         unsigned int size, unsigned long seed,
+                         const TetrisRenderer *render);
+int  tetris_record_step(TetrisRecorder *r, Tetris *g, char input, char tick);
+unsigned int tetris_record_end(TetrisRecorder *r);
+
+void tetris_replay_start(TetrisReplay *p, Tetris *g, const unsigned char *buf,
+                         unsigned int len, const TetrisRenderer *render);
+int  tetris_replay_tick(TetrisReplay *p, Tetris *g);
+
+#endif // included
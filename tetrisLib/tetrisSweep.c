@@ -0,0 +1,321 @@
+// --------------------------------------------------
+// Barrido de parámetros en Linux: millones de partidas del bot, sin
+// pantalla, repartidas entre todos los núcleos.
+//
+//   ./tetrisSweep [-j hilos] [-g 1/4,1,4] [-t 16x20,12x16] [-b 1,2,3]
+//                 [-p 5,10,15,20] [-d] [-n semillas] [-k por_tarea]
+//                 [-m piezas] [-s semilla0] > sweep.csv
+//
+// Cada combinación de gravedad (-g: pasos del bot por fila que cae;
+// "1/4" son cuatro filas por paso), tablero (-t: columnas x filas, o sea tamaño de bloque) y
+// bolsa (-b: copias de cada forma) juega las semillas s0..s0+n-1, una
+// partida por semilla, hasta perder o llegar a -m piezas.  -p da los
+// puntos de eliminar 1..4 filas de una vez.  El bot mueve la pieza
+// mientras cae con la gravedad; -d la suelta de golpe al llegar (y
+// entonces la gravedad casi no cuenta).  El motor se compila con
+// TETRIS_CONFIG y los máximos (make sweep).  Sale una fila CSV por
+// combinación.
+//
+// Las tareas (tramos de -k semillas) se reparten por turno entre los
+// hilos; cada hilo saca las suyas de un extremo de su cola y, al
+// vaciarla, roba del otro extremo de las colas ajenas.  Cada hilo suma
+// en sus propios totales y se juntan al final: no hay datos compartidos
+// mientras se juega.
+// --------------------------------------------------
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#include <pthread.h>
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#define CYCLES()  __rdtsc()
+#else
+#define CYCLES()  0ULL
+#endif
+#include "tetrisEngine.h"
+#include "tetrisBot.h"
+
+#define MAX_VALUES  16             // por lista de -g, -t o -b
+#define MAX_POINTS  64             // combinaciones
+
+typedef struct {
+  unsigned long games, pieces, lines, steps;
+  unsigned long long score;
+  unsigned long clears[4];      // fijadas que eliminaron 1..4 filas
+  unsigned long long ns, cycles;
+} Totals;
+
+typedef struct {
+  unsigned int moves, rows;     // gravedad: rows filas cada moves pasos del bot
+  TetrisConfig config;
+} Point;
+
+typedef struct {
+  unsigned int param;           // índice en points[]
+  unsigned long seed0;
+  unsigned int count;
+} Job;
+
+typedef struct {
+  pthread_mutex_t lock;
+  Job *jobs;
+  int head, tail;               // el dueño saca de tail, los ladrones de head
+  Totals totals[MAX_POINTS];
+  pthread_t thread;
+  int id;
+} Worker;
+
+static Point points[MAX_POINTS];
+static unsigned int numPoints;
+static unsigned int maxPieces = 1000;
+static char hardDrop;
+static Worker *workers;
+static int numWorkers;
+
+// --------------------------------------------------
+// Una partida del bot
+// --------------------------------------------------
+static void play(Totals *t, unsigned long seed, const Point *pt) {
+  Tetris g;
+  TetrisBot bot;
+  unsigned long steps = 0, moves = 0;
+  unsigned int pieces, lines;
+  int score, over = 0;
+
+  g.config = &pt->config;
+  tetris_init(&g, seed, NULL);
+  tetris_bot_init(&bot);
+  bot.hardDrop = hardDrop;
+  while (!over) {
+    // un paso del bot y las filas que caen hasta el siguiente
+    moves++;
+    int ticks = moves * pt->rows / pt->moves - (moves - 1) * pt->rows / pt->moves;
+    char input = tetris_bot_input(&bot, &g);
+    do {
+      pieces = g.pieces;
+      lines = g.lines;
+      score = g.score;
+      if (pieces >= maxPieces) {
+        over = 1;
+        break;
+      }
+      int ev = tetris_step(&g, input, ticks > 0);
+      steps++;
+      input = 0;
+      if (ev & TETRIS_NEWGAME) {        // perdió: g ya está vacío
+        over = 1;
+        break;
+      }
+      if (ev & TETRIS_CLEARED) t->clears[g.lines - lines - 1]++;
+    } while (--ticks > 0);
+  }
+  t->games++;
+  t->pieces += pieces;
+  t->lines += lines;
+  t->score += score;
+  t->steps += steps;
+}
+
+static void run_job(Worker *w, const Job *job) {
+  Totals *t = &w->totals[job->param];
+  struct timespec t0, t1;
+  clock_gettime(CLOCK_MONOTONIC, &t0);
+  unsigned long long c0 = CYCLES();
+  for (unsigned int i = 0; i < job->count; i++)
+    play(t, job->seed0 + i, &points[job->param]);
+  t->cycles += CYCLES() - c0;
+  clock_gettime(CLOCK_MONOTONIC, &t1);
+  t->ns += (t1.tv_sec - t0.tv_sec) * 1000000000ULL + (t1.tv_nsec - t0.tv_nsec);
+}
+
+// --------------------------------------------------
+// Colas con robo de tareas
+// --------------------------------------------------
+static int pop_own(Worker *w, Job *job) {
+  int ok = 0;
+  pthread_mutex_lock(&w->lock);
+  if (w->tail > w->head) {
+    *job = w->jobs[--w->tail];
+    ok = 1;
+  }
+  pthread_mutex_unlock(&w->lock);
+  return ok;
+}
+
+static int steal(Worker *w, Job *job) {
+  for (int i = 1; i < numWorkers; i++) {
+    Worker *v = &workers[(w->id + i) % numWorkers];
+    int ok = 0;
+    pthread_mutex_lock(&v->lock);
+    if (v->tail > v->head) {
+      *job = v->jobs[v->head++];
+      ok = 1;
+    }
+    pthread_mutex_unlock(&v->lock);
+    if (ok) return 1;
+  }
+  return 0;                             // nadie tiene trabajo: terminamos
+}
+
+static void *worker_main(void *arg) {
+  Worker *w = arg;
+  Job job;
+  while (pop_own(w, &job) || steal(w, &job))
+    run_job(w, &job);
+  return NULL;
+}
+
+// --------------------------------------------------
+// main
+// --------------------------------------------------
+// gravedades "4,1,1/4": pasos del bot por fila, o pasos/filas
+static unsigned int parse_gravity(char *list, unsigned int *moves, unsigned int *rows) {
+  unsigned int n = 0;
+  for (char *tok = strtok(list, ","); tok && n < MAX_VALUES; tok = strtok(NULL, ",")) {
+    char *slash;
+    moves[n] = strtoul(tok, &slash, 0);
+    rows[n] = *slash == '/' ? strtoul(slash + 1, 0, 0) : 1;
+    if (!moves[n]) moves[n] = 1;
+    if (!rows[n]) rows[n] = 1;
+    n++;
+  }
+  return n;
+}
+
+// lista de números separados por comas; 0 o de más pasan a 1
+static unsigned int parse_list(char *list, unsigned int *v, unsigned int max) {
+  unsigned int n = 0;
+  for (char *tok = strtok(list, ","); tok && n < MAX_VALUES; tok = strtok(NULL, ",")) {
+    v[n] = strtoul(tok, 0, 0);
+    if (v[n] < 1 || v[n] > max) v[n] = 1;
+    n++;
+  }
+  return n;
+}
+
+// tableros "16x20,12x16", dentro de 4x4..TETRIS_COLSxTETRIS_ROWS
+static unsigned int parse_boards(char *list, unsigned int *cols, unsigned int *rows) {
+  unsigned int n = 0;
+  for (char *tok = strtok(list, ","); tok && n < MAX_VALUES; tok = strtok(NULL, ",")) {
+    char *x;
+    cols[n] = strtoul(tok, &x, 0);
+    rows[n] = *x == 'x' ? strtoul(x + 1, 0, 0) : 0;
+    if (cols[n] < 4 || cols[n] > TETRIS_COLS || rows[n] < 4 || rows[n] > TETRIS_ROWS) {
+      fprintf(stderr, "tablero %s: de 4x4 a %dx%d\n", tok, TETRIS_COLS, TETRIS_ROWS);
+      exit(2);
+    }
+    n++;
+  }
+  return n;
+}
+
+int main(int argc, char **argv) {
+  unsigned long seeds = 100000, seed0 = 1;
+  unsigned int chunk = 256;
+  unsigned int moves[MAX_VALUES] = {4}, fall[MAX_VALUES] = {1}, numGravity = 1;
+  unsigned int cols[MAX_VALUES] = {16}, rows[MAX_VALUES] = {20}, numBoards = 1;
+  unsigned int bagMult[MAX_VALUES] = {2}, numBags = 1;
+  unsigned int lineScore[MAX_VALUES] = {5, 10, 15, 20};
+  int opt;
+
+  numWorkers = sysconf(_SC_NPROCESSORS_ONLN);
+  while ((opt = getopt(argc, argv, "j:g:t:b:p:dn:k:m:s:")) != -1) {
+    switch (opt) {
+    case 'j': numWorkers = atoi(optarg); break;
+    case 'g': numGravity = parse_gravity(optarg, moves, fall); break;
+    case 't': numBoards = parse_boards(optarg, cols, rows); break;
+    case 'b': numBags = parse_list(optarg, bagMult, TETRIS_BAG_MULT); break;
+    case 'p': parse_list(optarg, lineScore, ~0u >> 1); break;
+    case 'd': hardDrop = 1; break;
+    case 'n': seeds = strtoul(optarg, 0, 0); break;
+    case 'k': chunk = strtoul(optarg, 0, 0); break;
+    case 'm': maxPieces = strtoul(optarg, 0, 0); break;
+    case 's': seed0 = strtoul(optarg, 0, 0); break;
+    default:
+      fprintf(stderr, "uso: %s [-j hilos] [-g 1/4,1,4] [-t 16x20,12x16] [-b 1,2,3]"
+              " [-p 5,10,15,20] [-d] [-n semillas] [-k por_tarea]"
+              " [-m piezas] [-s semilla0]\n", argv[0]);
+      return 2;
+    }
+  }
+  if (numWorkers < 1) numWorkers = 1;
+  if (chunk < 1) chunk = 1;
+  if (numGravity < 1 || numBoards < 1 || numBags < 1) {
+    fprintf(stderr, "listas vacías\n");
+    return 2;
+  }
+
+  // una combinación por gravedad, tablero y bolsa
+  for (unsigned int b = 0; b < numBoards; b++)
+    for (unsigned int m = 0; m < numBags; m++)
+      for (unsigned int v = 0; v < numGravity && numPoints < MAX_POINTS; v++) {
+        Point *pt = &points[numPoints++];
+        pt->moves = moves[v];
+        pt->rows = fall[v];
+        pt->config.cols = cols[b];
+        pt->config.rows = rows[b];
+        pt->config.bagMult = bagMult[m];
+        for (int k = 0; k < 4; k++) pt->config.lineScore[k] = lineScore[k];
+      }
+
+  // tareas repartidas por turno; cada cola tiene lugar para todas
+  unsigned long perParam = (seeds + chunk - 1) / chunk;
+  unsigned long numJobs = perParam * numPoints;
+  workers = calloc(numWorkers, sizeof *workers);
+  for (int i = 0; i < numWorkers; i++) {
+    pthread_mutex_init(&workers[i].lock, NULL);
+    workers[i].jobs = malloc(((numJobs + numWorkers - 1) / numWorkers) * sizeof(Job));
+    workers[i].id = i;
+  }
+  unsigned long n = 0;
+  for (unsigned int p = 0; p < numPoints; p++) {
+    for (unsigned long s = 0; s < seeds; s += chunk, n++) {
+      Worker *w = &workers[n % numWorkers];
+      Job *job = &w->jobs[w->tail++];
+      job->param = p;
+      job->seed0 = seed0 + s;
+      job->count = seeds - s < chunk ? seeds - s : chunk;
+    }
+  }
+
+  struct timespec t0, t1;
+  clock_gettime(CLOCK_MONOTONIC, &t0);
+  for (int i = 0; i < numWorkers; i++)
+    pthread_create(&workers[i].thread, NULL, worker_main, &workers[i]);
+  for (int i = 0; i < numWorkers; i++)
+    pthread_join(workers[i].thread, NULL);
+  clock_gettime(CLOCK_MONOTONIC, &t1);
+  double wall = (t1.tv_sec - t0.tv_sec) + (t1.tv_nsec - t0.tv_nsec) / 1e9;
+
+  printf("cols,rows,bag_mult,gravity_moves,gravity_rows,hard_drop,games,pieces,lines,score,"
+         "singles,doubles,triples,tetrises,steps,ns_per_step,cycles_per_step\n");
+  unsigned long games = 0;
+  for (unsigned int p = 0; p < numPoints; p++) {
+    const Point *pt = &points[p];
+    Totals t;
+    memset(&t, 0, sizeof t);
+    for (int i = 0; i < numWorkers; i++) {
+      const Totals *w = &workers[i].totals[p];
+      t.games += w->games;
+      t.pieces += w->pieces;
+      t.lines += w->lines;
+      t.score += w->score;
+      t.steps += w->steps;
+      t.ns += w->ns;
+      t.cycles += w->cycles;
+      for (int k = 0; k < 4; k++) t.clears[k] += w->clears[k];
+    }
+    games += t.games;
+    printf("%d,%d,%d,%u,%u,%d,%lu,%lu,%lu,%llu,%lu,%lu,%lu,%lu,%lu,%.1f,%.1f\n",
+           pt->config.cols, pt->config.rows, pt->config.bagMult, pt->moves, pt->rows, hardDrop,
+           t.games, t.pieces, t.lines, t.score,
+           t.clears[0], t.clears[1], t.clears[2], t.clears[3], t.steps,
+           t.steps ? (double)t.ns / t.steps : 0.0,
+           t.steps ? (double)t.cycles / t.steps : 0.0);
+  }
+  fprintf(stderr, "%lu games on %d threads in %.2f s (%.0f games/s)\n",
+          games, numWorkers, wall, wall > 0 ? games / wall : 0.0);
+  return 0;
+}
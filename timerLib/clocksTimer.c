@@ -1,6 +1,10 @@
 #include <msp430.h>
 #include "libTimer.h"
 
+unsigned int wdtTicksPerSec = 244; // SMCLK (2MHz) / 8192
+unsigned int aclkHz = 0;
+unsigned char lpmBits = 0x10;	   // LPM0: CPU off, SMCLK keeps running
+
 void configureClocks(){
   WDTCTL = WDTPW + WDTHOLD;//Disable Watchdog Timer
   BCSCTL1 = CALBC1_16MHZ;  // Set DCO to 16 Mhz
@@ -11,8 +15,54 @@ void configureClocks(){
 }
 
 
+// Measure the VLO against SMCLK (2MHz from the calibrated DCO): Timer
+// A0 counts SMCLK and captures on ACLK's rising edges (CCI0B), over
+// VLO_PERIODS periods.  Timer A0's registers are put back afterwards.
+#define VLO_PERIODS 64		   // 3.2..16ms of SMCLK counts: no wrap
+
+static unsigned int
+measureVLO()
+{
+  unsigned int ctl = TA0CTL, ccr0 = TA0CCR0, cctl0 = TA0CCTL0;
+  unsigned int first, last;
+  int n;
+
+  TA0CTL = TASSEL_2 | MC_2 | TACLR;		    // SMCLK, continuous
+  TA0CCTL0 = CM_1 | CCIS_1 | SCS | CAP;		    // ACLK rising edge
+  for (n = -1; n < VLO_PERIODS; n++) {	    // first capture: the start
+    TA0CCTL0 &= ~CCIFG;
+    while (!(TA0CCTL0 & CCIFG))
+      ;
+    if (n < 0)
+      first = TA0CCR0;
+  }
+  last = TA0CCR0;
+  TA0CTL = ctl & ~TAIFG;
+  TA0CCR0 = ccr0;
+  TA0CCTL0 = cctl0 & ~CCIFG;
+  return (2000000L * VLO_PERIODS) / (unsigned int)(last - first);
+}
+
+// select ACLK's source: VLO or a 32kHz crystal
+void configureACLK(char source)
+{
+  BCSCTL1 &= ~DIVA_3;		   // ACLK undivided
+  if (source == ACLK_XTAL) {
+    BCSCTL3 = LFXT1S_0 | XCAP_3;   // 32768Hz crystal, 12.5pF load
+    do {			   // wait for the crystal to settle
+      IFG1 &= ~OFIFG;
+      __delay_cycles(16000);
+    } while (IFG1 & OFIFG);
+    aclkHz = 32768;
+  } else {
+    BCSCTL3 = LFXT1S_2;		   // VLO: nominal 12kHz, 4..20kHz per chip
+    aclkHz = measureVLO();	   // so periods from aclkHz hold on every chip
+  }
+}
+
+
 // enable watchdog timer periodic interrupt
-// period = SMCLOCK/32k
+// period = SMCLOCK/8k
 void enableWDTInterrupts()  
 {
   WDTCTL = WDTPW |	   // passwd req'd.  Otherwise device resets
@@ -20,6 +70,24 @@ void enableWDTInterrupts()
     WDTCNTCL |		     // clear watchdog count
     1;			     // divide SMCLK by 8192
   IE1 |= WDTIE;		   // Enable watchdog interval timer interrupt
+  wdtTicksPerSec = 244;
+  lpmBits = 0x10;
+}
+
+
+// enable watchdog timer periodic interrupt clocked from ACLK
+// (call configureACLK first).  period = ACLK/64
+// Since the tick no longer needs SMCLK, powerSleep may use LPM3.
+void enableWDTInterruptsACLK()
+{
+  WDTCTL = WDTPW |		   // passwd req'd.  Otherwise device resets
+    WDTTMSEL |			   // watchdog interval mode 
+    WDTCNTCL |			   // clear watchdog count
+    WDTSSEL |			   // source: ACLK
+    3;				   // divide ACLK by 64
+  IE1 |= WDTIE;			   // Enable watchdog interval timer interrupt
+  wdtTicksPerSec = aclkHz / 64;
+  lpmBits = 0xd0;		   // LPM3: CPU, DCO and SMCLK off
 }
 
 
@@ -1,8 +1,17 @@
 #ifndef timerLib_included
 #define timerLib_included
 
+#define ACLK_VLO  0		// internal ~12kHz oscillator, no parts needed
+#define ACLK_XTAL 1		// 32768Hz watch crystal on XIN/XOUT
+
+extern unsigned int wdtTicksPerSec; // rate of the WDT interval interrupt
+extern unsigned int aclkHz;	    // 0 until configureACLK (VLO: measured)
+extern unsigned char lpmBits;	    // SR bits used by powerSleep
+
 void configureClocks();
+void configureACLK(char source); // after configureClocks; borrows Timer A0
 void enableWDTInterrupts();
+void enableWDTInterruptsACLK();
 void timerAUpmode();
 
 #endif
@@ -3,5 +3,6 @@
 
 #include "clocksTimer.h"
 #include "sr.h"
+#include "powerStats.h"
 
 #endif // included
@@ -0,0 +1,112 @@
+#include <msp430.h>
+#include "libTimer.h"
+
+// Timer A1 runs continuously from SMCLK/8 (2MHz/8 = 250kHz, 4us per
+// count).  The 16 bit counter wraps every 262ms; intervals are taken
+// as unsigned differences, which is safe as long as some transition
+// (e.g. the WDT tick) happens more often than that.
+//
+// In LPM3 (tick from ACLK) SMCLK stops, and Timer A1 with it, so it
+// only times the awake states.  The window's length then comes from
+// the WDT ticks counted by powerIsrEnter (aclkHz is measured, see
+// configureACLK) and the time asleep is the rest of it.
+#define STAMP_HZ 250000L
+
+static unsigned int lastStamp;
+static char state = PWR_ACTIVE;
+static unsigned long spent[PWR_STATES];
+static unsigned int wakeups;
+static unsigned int wdtTicks;
+
+static unsigned int
+stamp()
+{
+  unsigned int a, b;
+  do {				// TAR may be mid-update; read until stable
+    a = TA1R;
+    b = TA1R;
+  } while (a != b);
+  return a;
+}
+
+// charge time since the last transition to the current state
+static void
+charge()
+{
+  unsigned int now = stamp();
+  spent[state] += (unsigned int)(now - lastStamp);
+  lastStamp = now;
+}
+
+void powerStatsInit()
+{
+  TA1CTL = TASSEL_2 | ID_3 | MC_2 | TACLR; // SMCLK/8, continuous mode
+  lastStamp = stamp();
+  state = PWR_ACTIVE;
+  wdtTicks = 0;
+}
+
+// enter LPM0 (LPM3 with an ACLK tick) until a handler clears the LPM bits
+void powerSleep()
+{
+  and_sr(~0x8);			// keep handlers out of the bookkeeping
+  charge();
+  state = PWR_LPM;
+  if (lpmBits & 0x80)		// SMCLK also clocks the LCD's SPI port:
+    while (UCB0STAT & UCBUSY);	// let the last byte go out first
+  or_sr(lpmBits | 0x8);		// sleep and GIE in one write: no lost wakeup
+  and_sr(~0x8);
+  charge();			// time after the waking handler returned
+  state = PWR_ACTIVE;
+  or_sr(0x8);
+}
+
+// call first thing in a handler; returns the state to hand to powerIsrExit
+char powerIsrEnter(char isrState)
+{
+  char prev = state;
+  charge();
+  if (prev == PWR_LPM)
+    wakeups++;
+  if (isrState == PWR_ISR_WDT)
+    wdtTicks++;
+  state = isrState;
+  return prev;
+}
+
+void powerIsrExit(char prevState)
+{
+  charge();
+  state = prevState;
+}
+
+// summarize the window since the previous report and start a new one
+void powerStatsReport(PowerReport *report)
+{
+  unsigned long total = 0, scale;
+  int sr = get_sr();
+  char s;
+
+  and_sr(~0x8);			// no transitions while we read
+  charge();
+  if (lpmBits & 0x80) {		// Timer A1 was stopped while asleep
+    unsigned long window =	// WDT ticks of 64 ACLK periods, in stamps
+      ((unsigned long)wdtTicks * ((STAMP_HZ * 64 << 4) / aclkHz)) >> 4;
+    spent[PWR_LPM] = 0;
+    for (s = 0; s < PWR_STATES; s++)
+      total += spent[s];
+    spent[PWR_LPM] = window > total ? window - total : 0;
+    total = 0;
+  }
+  wdtTicks = 0;
+  for (s = 0; s < PWR_STATES; s++)
+    total += spent[s];
+  scale = total / 100;
+  for (s = 0; s < PWR_STATES; s++) {
+    report->percent[s] = scale ? spent[s] / scale : 0;
+    spent[s] = 0;
+  }
+  report->wakeupsPerSec = total ? (wakeups * STAMP_HZ) / total : 0;
+  wakeups = 0;
+  set_sr(sr);
+}
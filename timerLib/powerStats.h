@@ -0,0 +1,29 @@
+#ifndef powerStats_included
+#define powerStats_included
+
+// Idle/active accounting.  Every transition between main, low power
+// mode and an interrupt handler is timestamped with Timer A1 (SMCLK/8,
+// 4us) and the elapsed time is charged to the state that was just
+// left.  With an ACLK tick (LPM3) the time asleep is the window, from
+// the PWR_ISR_WDT entries, less the time awake.
+
+#define PWR_ACTIVE     0	// main program running
+#define PWR_LPM        1	// CPU off (sleeping in powerSleep)
+#define PWR_ISR_WDT    2	// per-handler states; passed to powerIsrEnter
+#define PWR_ISR_PORT1  3
+#define PWR_ISR_PORT2  4
+#define PWR_ISR_TIMER  5
+#define PWR_STATES     6
+
+typedef struct {
+  unsigned char percent[PWR_STATES]; // share of the window spent in each state
+  unsigned int wakeupsPerSec;	     // LPM exits per second over the window
+} PowerReport;
+
+void powerStatsInit();
+void powerSleep();
+char powerIsrEnter(char state);
+void powerIsrExit(char prevState);
+void powerStatsReport(PowerReport *report);
+
+#endif
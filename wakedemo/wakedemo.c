@@ -2,6 +2,8 @@
 #include <libTimer.h>
 #include "lcdutils.h"
 #include "lcddraw.h"
+#include "lcdmove.h"
+#include "lcdshapes.h"
 
 // WARNING: LCD DISPLAY USES P1.0.  Do not touch!!! 
 
@@ -62,15 +64,14 @@ draw_ball(int col, int row, unsigned short color)
 void
 screen_update_ball()
 {
-  for (char axis = 0; axis < 2; axis ++) 
-    if (drawPos[axis] != controlPos[axis]) /* position changed? */
-      goto redraw;
-  return;			/* nothing to do */
- redraw:
-  draw_ball(drawPos[0], drawPos[1], COLOR_BLUE); /* erase */
+  signed char dx = controlPos[0] - drawPos[0], dy = controlPos[1] - drawPos[1];
+  if (!dx && !dy)
+    return;			/* nothing to do */
+  /* only the trailing edge (erase) and leading edge (draw) change */
+  moveRectangle(drawPos[0]-1, drawPos[1]-1, 3, 3, dx, dy,
+		COLOR_WHITE, COLOR_BLUE);
   for (char axis = 0; axis < 2; axis ++) 
     drawPos[axis] = controlPos[axis];
-  draw_ball(drawPos[0], drawPos[1], COLOR_WHITE); /* draw */
 }
   
 
@@ -82,7 +83,7 @@ void wdt_c_handler()
   static int secCount = 0;
 
   secCount ++;
-  if (secCount >= 25) {		/* 10/sec */
+  if (secCount >= wdtTicksPerSec / 10) { /* 10/sec */
    
     {				/* move ball */
       short oldCol = controlPos[0];
@@ -119,42 +120,53 @@ void main()
   lcd_init();
   switch_init();
   
-  enableWDTInterrupts();      /**< enable periodic interrupt */
+  configureACLK(ACLK_VLO);
+  enableWDTInterruptsACLK();  /**< periodic interrupt from ACLK: sleep in LPM3 */
   or_sr(0x8);	              /**< GIE (enable interrupts) */
   
   clearScreen(COLOR_BLUE);
+  draw_ball(drawPos[0], drawPos[1], COLOR_WHITE); /* moved by its edges */
   while (1) {			/* forever */
     if (redrawScreen) {
       redrawScreen = 0;
       update_shape();
     }
     P1OUT &= ~LED;	/* led off */
-    or_sr(0x10);	/**< CPU OFF */
+    powerSleep();	/**< CPU (and SMCLK) OFF */
     P1OUT |= LED;	/* led on */
   }
 }
 
+/* the full hourglass: two triangles meeting at the center */
+#define HG_COL  (screenWidth / 2)
+#define HG_ROW  (screenHeight / 2)
+#define HG_SIZE 31		/* step runs 0..31 */
+static const u_char hourglassTop[] = {
+  HG_COL, HG_ROW,  HG_COL - HG_SIZE, HG_ROW - HG_SIZE,  HG_COL + HG_SIZE, HG_ROW - HG_SIZE
+};
+static const u_char hourglassBottom[] = {
+  HG_COL, HG_ROW,  HG_COL + HG_SIZE, HG_ROW + HG_SIZE,  HG_COL - HG_SIZE, HG_ROW + HG_SIZE
+};
+
 void
 screen_update_hourglass()
 {
-  static unsigned char row = screenHeight / 2, col = screenWidth / 2;
-  static char lastStep = 0;
+  static char lastStep = 0;	/* rows drawn on each side of the center */
   
   if (step == 0 || (lastStep > step)) {
-    clearScreen(COLOR_BLUE);
+    if (lastStep) {		/* erase just the hourglass' own spans */
+      fillConvexPolygonRows(hourglassTop, 3, HG_ROW - lastStep + 1, HG_ROW, COLOR_BLUE);
+      fillConvexPolygonRows(hourglassBottom, 3, HG_ROW, HG_ROW + lastStep - 1, COLOR_BLUE);
+    }
     lastStep = 0;
   } else {
-    for (; lastStep <= step; lastStep++) {
-      int startCol = col - lastStep;
-      int endCol = col + lastStep;
-      int width = 1 + endCol - startCol;
-      
-      // a color in this BGR encoding is BBBB BGGG GGGR RRRR
-      unsigned int color = (blue << 11) | (green << 5) | red;
-      
-      fillRectangle(startCol, row+lastStep, width, 1, color);
-      fillRectangle(startCol, row-lastStep, width, 1, color);
-    }
+    // a color in this BGR encoding is BBBB BGGG GGGR RRRR
+    unsigned int color = (blue << 11) | (green << 5) | red;
+
+    /* grow: only the rows added since the last update */
+    fillConvexPolygonRows(hourglassTop, 3, HG_ROW - step, HG_ROW - lastStep, color);
+    fillConvexPolygonRows(hourglassBottom, 3, HG_ROW + lastStep, HG_ROW + step, color);
+    lastStep = step + 1;
   }
 }  
 